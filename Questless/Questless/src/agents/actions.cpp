@@ -10,6 +10,19 @@
 #include "world/region.hpp"
 
 namespace ql {
+	namespace {
+		//! How long it takes to perform an action per action point it costs.
+		constexpr auto action_duration = 1_tick / 1_ap;
+	}
+
+	auto spend(reg& reg, id actor_id, action cost) -> void {
+		reg.get<body>(actor_id).cond.busy_time += cost * action_duration;
+	}
+
+	auto wait(reg& reg, id waiter_id, tick duration) -> void {
+		reg.get<body>(waiter_id).cond.busy_time += duration;
+	}
+
 	auto turn(reg& reg, id turner_id, hex_direction direction) -> void {
 		auto& body = reg.get<ql::body>(turner_id);
 
@@ -18,6 +31,7 @@ namespace ql {
 		auto const turn_cost = base_cost + cost_per_turn * distance(body.cond.direction, direction);
 
 		//! @todo Spend leg ability points.
+		spend(reg, turner_id, turn_cost);
 
 		body.cond.direction = direction;
 	}
@@ -26,13 +40,11 @@ namespace ql {
 		auto [body, location] = reg.get<ql::body, ql::location>(walker_id);
 
 		constexpr auto base_cost = 1_ap;
-		constexpr auto cost_per_turn = 1_tick;
+		constexpr auto cost_per_turn = 1_ap;
 
 		auto& region = reg.get<ql::region>(location.region_id);
 
 		//! @todo Spend leg ability points.
-		// cond.busy_time += cancel::quantity_cast<tick>(agility_factor * (base_delay + strafe_delay));
-
 		//! @todo Account for terrain.
 
 		// Move the being.
@@ -40,6 +52,7 @@ namespace ql {
 
 		// Increase busy time.
 		auto const strafe_cost = cost_per_turn * distance(body.cond.direction, direction);
+		spend(reg, walker_id, base_cost + strafe_cost);
 	}
 
 	auto move(reg& reg, id mover_id, hex_direction direction, bool strafe) -> void {
@@ -73,9 +86,8 @@ namespace ql {
 		auto const& location = reg.get<ql::location>(dropper_id);
 		auto& region = reg.get<ql::region>(location.region_id);
 		// The tile certainly exists because a being is located on it, so it's safe to dereference without a check here.
-		id tile_id = *region.tile_id_at(location.coords);
 		// Add item to the tile's inventory.
-		reg.get<inventory>(tile_id).add(item_id);
+		region.ground_items_at(location.coords)->add(item_id);
 	}
 
 	auto toss(reg& reg, id thrower_id, id item_id) -> void {
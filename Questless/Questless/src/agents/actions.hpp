@@ -4,10 +4,18 @@
 
 #pragma once
 
+#include "quantities/game_time.hpp"
+#include "quantities/misc.hpp"
 #include "reg.hpp"
 #include "world/coordinates.hpp"
 
 namespace ql {
+	//! Occupies @p actor_id for as long as it takes to perform an action costing @p cost.
+	auto spend(reg& reg, id actor_id, action cost) -> void;
+
+	//! Occupies @p waiter_id for @p duration without doing anything.
+	auto wait(reg& reg, id waiter_id, tick duration) -> void;
+
 	auto turn(reg& reg, id turner_id, hex_direction direction) -> void;
 
 	auto walk(reg& reg, id walker_id, hex_direction direction) -> void;
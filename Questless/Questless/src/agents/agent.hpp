@@ -7,6 +7,7 @@
 #include "lazy_ai.hpp"
 #include "player.hpp"
 
+#include "utility/task.hpp"
 #include "utility/visitation.hpp"
 
 #include <variant>
@@ -18,8 +19,8 @@ namespace ql {
 
 		agent(std::variant<basic_ai, lazy_ai, player> value) : value{std::move(value)} {}
 
-		//! Allows the agent to perform actions.
-		auto act() -> std::future<void> {
+		//! Allows the agent to perform actions. The returned task has not been started yet.
+		auto act() -> task {
 			return match(value, [](auto& value) { return value.act(); });
 		}
 
@@ -8,22 +8,20 @@
 #include "effects/effect.hpp"
 #include "entities/beings/being.hpp"
 #include "entities/perception.hpp"
-#include "utility/future.hpp"
 #include "utility/random.hpp"
 #include "utility/visitation.hpp"
 
 namespace ql {
 	basic_ai::basic_ai(reg& reg, id id) : _reg{&reg}, _id{id} {}
 
-	auto basic_ai::act() -> std::future<void> {
+	auto basic_ai::act() -> task {
 		return match(
 			_state,
 			[this](idle_state) {
-				if (bernoulli_trial(0.1)) {
-					// Walk next time.
-					_state = walk_state{};
-				}
-				return make_ready_future();
+				// Idle for a while, then walk. Waiting lets the scheduler leave this AI alone until it's done idling.
+				wait(*_reg, _id, uniform(1_tick, 19_tick));
+				_state = walk_state{};
+				return task{};
 			},
 			[this](walk_state) {
 				// Randomly either move in current direction or turn towards a random direction.
@@ -34,19 +32,19 @@ namespace ql {
 				}
 				// Idle next time.
 				_state = idle_state{};
-				return make_ready_future();
+				return task{};
 			},
 			[this](attack_state const& as) {
 				if (!_reg->valid(as.target_id)) {
 					// Target not found. Switch to idle state.
 					_state = idle_state{};
-					return make_ready_future();
+					return task{};
 				}
 				auto const& target_location = _reg->get<location>(as.target_id);
 				if (perception_of(*_reg, _id, target_location.coords) <= 0_perception) {
 					// Target not visible. Switch to idle state.
 					_state = idle_state{};
-					return make_ready_future();
+					return task{};
 					//! @todo Only go passive while target is out of visual range. Keep a grudge list?
 				} else {
 					auto target_direction = (target_location.coords - target_location.coords).direction();
@@ -54,18 +52,18 @@ namespace ql {
 					if (target_body.cond.direction != target_direction) {
 						// Facing away from target. Turn towards it.
 						turn(*_reg, _id, target_direction);
-						return make_ready_future();
+						return task{};
 					} else {
 						// Facing towards target.
 						if ((target_location.coords - target_location.coords).length() == 1_pace) {
 							// Within striking distance of target.
 
 							//! @todo Find and use melee weapon in inventory, if present.
-							return make_ready_future();
+							return task{};
 						} else {
 							// Out of range. Move towards target.
 							walk(*_reg, _id, target_direction);
-							return make_ready_future();
+							return task{};
 						}
 					}
 				}
@@ -4,8 +4,8 @@
 #pragma once
 
 #include "reg.hpp"
+#include "utility/task.hpp"
 
-#include <future>
 #include <variant>
 
 namespace ql {
@@ -17,7 +17,8 @@ namespace ql {
 	struct basic_ai {
 		basic_ai(reg& reg, id id);
 
-		auto act() -> std::future<void>;
+		//! Performs this AI's next action. AI actions complete immediately, so the task is always already complete.
+		auto act() -> task;
 
 		auto perceive(effects::effect const& effect) -> void;
 
@@ -0,0 +1,23 @@
+//! @file
+//! @copyright See <a href="LICENSE.txt">LICENSE.txt</a>.
+
+#include "command_script.hpp"
+
+#include <cassert>
+
+namespace ql {
+	command_script::command_script(std::vector<recorded_command> commands) : _commands{std::move(commands)} {}
+
+	auto command_script::command_awaitable::await_ready() const -> bool {
+		return !script->done() && script->next_tick() == script->_tick;
+	}
+
+	auto command_script::command_awaitable::await_resume() const -> player_command {
+		assert(await_ready());
+		return script->_commands[script->_next_idx++].command;
+	}
+
+	auto command_script::next_command() -> command_awaitable {
+		return {this};
+	}
+}
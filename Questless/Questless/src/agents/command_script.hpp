@@ -0,0 +1,64 @@
+//! @file
+//! @copyright See <a href="LICENSE.txt">LICENSE.txt</a>.
+
+#pragma once
+
+#include "player_command.hpp"
+
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ql {
+	//! A player command and the simulation tick during which it was performed.
+	struct recorded_command {
+		std::uint64_t tick;
+		player_command command;
+
+		template <typename Archive>
+		auto serialize(Archive& archive) -> void {
+			archive(tick, command);
+		}
+	};
+
+	//! Feeds recorded commands to the player in place of a HUD, such as when replaying a session. Each command is only
+	//! given out during the tick it was recorded in.
+	struct command_script {
+		explicit command_script(std::vector<recorded_command> commands);
+
+		//! Awaitable that yields the next command if it's due, and otherwise suspends the awaiting coroutine for good.
+		struct command_awaitable {
+			command_script* script;
+
+			auto await_ready() const -> bool;
+
+			auto await_suspend(std::coroutine_handle<>) const -> void {}
+
+			auto await_resume() const -> player_command;
+		};
+
+		//! Awaits the next command.
+		auto next_command() -> command_awaitable;
+
+		//! Sets the tick that is being simulated to @p tick.
+		auto set_tick(std::uint64_t tick) -> void {
+			_tick = tick;
+		}
+
+		//! Whether every command has been given out.
+		auto done() const -> bool {
+			return _next_idx == _commands.size();
+		}
+
+		//! The tick during which the next command was recorded. Only call if not @p done.
+		auto next_tick() const -> std::uint64_t {
+			return _commands[_next_idx].tick;
+		}
+
+	private:
+		std::vector<recorded_command> _commands;
+		std::size_t _next_idx = 0;
+		std::uint64_t _tick = 0;
+	};
+}
@@ -4,7 +4,7 @@
 #pragma once
 
 #include "reg.hpp"
-#include "utility/future.hpp"
+#include "utility/task.hpp"
 
 namespace ql {
 	namespace effects {
@@ -15,8 +15,8 @@ namespace ql {
 	struct lazy_ai {
 		id id;
 
-		auto act() -> std::future<void> {
-			return make_ready_future();
+		auto act() -> task {
+			return {};
 		}
 
 		auto perceive(effects::effect const&) -> void {}
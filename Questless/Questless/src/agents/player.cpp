@@ -3,21 +3,35 @@
 
 #include "player.hpp"
 
+#include "command_script.hpp"
+#include "player_command.hpp"
+
 #include "ui/hud.hpp"
 
+#include <variant>
+
 namespace ql {
-	player::player(hud* hud) : _hud{hud} {}
+	player::player(reg& reg, id id, hud* hud) : _reg{&reg}, _id{id}, _hud{hud} {}
 
-	auto player::act() -> std::future<void> {
-		// Allow the player to perform actions via the HUD until passing the turn.
-		return _hud->pass_future();
+	auto player::act() -> task {
+		// Perform the player's commands until the player passes the turn.
+		for (;;) {
+			auto const command = _script ? co_await _script->next_command() : co_await _hud->next_command();
+			if (std::holds_alternative<commands::pass>(command)) { co_return; }
+			perform(*_reg, _id, command);
+		}
 	}
 
 	auto player::perceive(effects::effect const& effect) -> void {
-		_hud->render_effect(effect);
+		// Without a HUD, such as in a replay, there's no one to show the effect to.
+		if (_hud) { _hud->render_effect(effect); }
 	}
 
 	auto player::set_hud(hud& hud) -> void {
 		_hud = &hud;
 	}
+
+	auto player::set_script(command_script& script) -> void {
+		_script = &script;
+	}
 }
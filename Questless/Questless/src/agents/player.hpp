@@ -4,26 +4,34 @@
 #pragma once
 
 #include "reg.hpp"
-
-#include <future>
+#include "utility/task.hpp"
 
 namespace ql {
 	namespace effects {
 		struct effect;
 	}
+	struct command_script;
 	struct hud;
 
 	//! The agent representing the player's control over his or her character.
 	struct player {
-		player(hud* hud = nullptr);
+		player(reg& reg, id id, hud* hud = nullptr);
 
-		auto act() -> std::future<void>;
+		//! Performs the player's commands from the HUD, or the command script if there is one, suspending while
+		//! awaiting them, until the player passes the turn.
+		auto act() -> task;
 
 		auto perceive(effects::effect const& effect) -> void;
 
 		auto set_hud(hud& hud) -> void;
 
+		//! Takes commands from @p script instead of the HUD.
+		auto set_script(command_script& script) -> void;
+
 	private:
+		reg_ptr _reg;
+		id _id;
 		hud* _hud;
+		command_script* _script = nullptr;
 	};
 }
@@ -0,0 +1,52 @@
+//! @file
+//! @copyright See <a href="LICENSE.txt">LICENSE.txt</a>.
+
+#include "player_command.hpp"
+
+#include "actions.hpp"
+
+#include "items/equipment.hpp"
+#include "items/weapons/bow.hpp"
+#include "items/weapons/quarterstaff.hpp"
+#include "utility/visitation.hpp"
+
+namespace ql {
+	namespace {
+		//! The @p Component of the item @p item_id, or null if the item no longer exists or has no such component.
+		template <typename Component>
+		auto try_get_item(reg& reg, id item_id) -> Component* {
+			return reg.valid(item_id) ? reg.try_get<Component>(item_id) : nullptr;
+		}
+	}
+
+	auto perform(reg& reg, id player_id, player_command const& command) -> void {
+		match(
+			command,
+			[](commands::pass) {},
+			[&](commands::move const& move) { ql::move(reg, player_id, move.direction, move.strafe); },
+			[&](commands::equip const& equip) {
+				if (auto equipment = try_get_item<ql::equipment>(reg, equip.item_id)) { equipment->equip(player_id); }
+			},
+			[&](commands::unequip const& unequip) {
+				if (auto equipment = try_get_item<ql::equipment>(reg, unequip.item_id)) { equipment->unequip(); }
+			},
+			[&](commands::drop const& drop) {
+				if (reg.valid(drop.item_id)) { ql::drop(reg, player_id, drop.item_id); }
+			},
+			[&](commands::toss const& toss) {
+				if (reg.valid(toss.item_id)) { ql::toss(reg, player_id, toss.item_id); }
+			},
+			[&](commands::draw const& draw) {
+				if (auto bow = try_get_item<ql::bow>(reg, draw.item_id)) { bow->draw(); }
+			},
+			[&](commands::loose const& loose) {
+				if (auto bow = try_get_item<ql::bow>(reg, loose.item_id)) { bow->loose(); }
+			},
+			[&](commands::strike const& strike) {
+				if (auto quarterstaff = try_get_item<ql::quarterstaff>(reg, strike.item_id)) { quarterstaff->strike(); }
+			},
+			[&](commands::jab const& jab) {
+				if (auto quarterstaff = try_get_item<ql::quarterstaff>(reg, jab.item_id)) { quarterstaff->jab(); }
+			});
+	}
+}
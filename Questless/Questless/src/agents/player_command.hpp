@@ -0,0 +1,67 @@
+//! @file
+//! @copyright See <a href="LICENSE.txt">LICENSE.txt</a>.
+
+#pragma once
+
+#include "reg.hpp"
+#include "world/coordinates.hpp"
+
+#include <variant>
+
+namespace ql {
+	//! Compact records of the player's intents, issued on the UI thread and performed on the game logic thread.
+	namespace commands {
+		//! Ends the player's turn.
+		struct pass {
+			template <typename Archive>
+			auto serialize(Archive&) -> void {}
+		};
+
+		//! Moves or turns towards @p direction, or strafes in @p direction if @p strafe is true.
+		struct move {
+			hex_direction direction;
+			bool strafe;
+
+			template <typename Archive>
+			auto serialize(Archive& archive) -> void {
+				archive(direction, strafe);
+			}
+		};
+
+		//! A command to use the item @p item_id in a particular way, given by @p Tag.
+		template <typename Tag>
+		struct item_command {
+			id item_id;
+
+			template <typename Archive>
+			auto serialize(Archive& archive) -> void {
+				archive(item_id);
+			}
+		};
+
+		using equip = item_command<struct equip_tag>;
+		using unequip = item_command<struct unequip_tag>;
+		using drop = item_command<struct drop_tag>;
+		using toss = item_command<struct toss_tag>;
+		using draw = item_command<struct draw_tag>;
+		using loose = item_command<struct loose_tag>;
+		using strike = item_command<struct strike_tag>;
+		using jab = item_command<struct jab_tag>;
+	}
+
+	using player_command = std::variant< //
+		commands::pass,
+		commands::move,
+		commands::equip,
+		commands::unequip,
+		commands::drop,
+		commands::toss,
+		commands::draw,
+		commands::loose,
+		commands::strike,
+		commands::jab>;
+
+	//! Performs @p command as the player-controlled being @p player_id. Commands on items that no longer exist do
+	//! nothing.
+	auto perform(reg& reg, id player_id, player_command const& command) -> void;
+}
@@ -0,0 +1,37 @@
+//! @file
+//! @copyright See <a href="LICENSE.txt">LICENSE.txt</a>.
+
+#include "turn_scheduler.hpp"
+
+#include "world/region.hpp"
+
+namespace ql {
+	turn_scheduler::turn_scheduler(reg& reg) : _reg{&reg} {}
+
+	auto turn_scheduler::schedule(id being_id, tick ready_time) -> void {
+		auto const ticket = _next_ticket++;
+		if (auto schedule = _reg->try_get<turn_schedule>(being_id)) {
+			schedule->ready_time = ready_time;
+			schedule->ticket = ticket;
+		} else {
+			_reg->assign<turn_schedule>(being_id, ready_time, ready_time, ticket);
+		}
+		_queue.push({ready_time, ticket, being_id});
+	}
+
+	auto turn_scheduler::pop_ready(tick now) -> std::optional<id> {
+		while (!_queue.empty() && _queue.top().ready_time <= now) {
+			auto const top = _queue.top();
+			_queue.pop();
+			if (!_reg->valid(top.being_id) || _reg->has<dormant>(top.being_id) ||
+				_reg->has<frozen>(top.being_id)) {
+				continue;
+			}
+			auto const& schedule = _reg->get<turn_schedule>(top.being_id);
+			// Skip entries superseded by a later call to schedule.
+			if (schedule.ticket != top.ticket) { continue; }
+			return top.being_id;
+		}
+		return std::nullopt;
+	}
+}
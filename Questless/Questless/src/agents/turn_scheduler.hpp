@@ -0,0 +1,60 @@
+//! @file
+//! @copyright See <a href="LICENSE.txt">LICENSE.txt</a>.
+
+#pragma once
+
+#include "quantities/game_time.hpp"
+#include "reg.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <queue>
+#include <vector>
+
+namespace ql {
+	//! When a being may next act. Assigned and maintained by a @p turn_scheduler.
+	struct turn_schedule {
+		//! The time at which the being's next turn begins.
+		tick ready_time;
+
+		//! The time up to which the being's body has been updated. Bodies are only updated when their beings act.
+		tick last_update;
+
+		//! Identifies the being's current entry in its scheduler's queue. Entries with other tickets are stale.
+		std::uint64_t ticket;
+	};
+
+	//! Orders beings by the time of their next turn, so that only beings whose turns have come need to be visited.
+	struct turn_scheduler {
+		turn_scheduler(reg& reg);
+
+		//! Schedules the next turn of @p being_id to begin at @p ready_time, replacing any turn already scheduled.
+		auto schedule(id being_id, tick ready_time) -> void;
+
+		//! Removes and returns the ID of a being whose turn begins at or before @p now, or nullopt if there is none.
+		//! Beings whose turns begin at the same time are returned in the order they were scheduled. Destroyed,
+		//! dormant, and frozen beings are dropped; they must be rescheduled when they wake or thaw.
+		auto pop_ready(tick now) -> std::optional<id>;
+
+	private:
+		struct entry {
+			tick ready_time;
+			std::uint64_t ticket;
+			id being_id;
+		};
+
+		//! Orders entries so that the earliest, and then the first scheduled, is at the top of the queue.
+		struct later {
+			auto operator()(entry const& left, entry const& right) const -> bool {
+				if (left.ready_time != right.ready_time) { return left.ready_time > right.ready_time; }
+				return left.ticket > right.ticket;
+			}
+		};
+
+		reg_ptr _reg;
+
+		std::priority_queue<entry, std::vector<entry>, later> _queue;
+
+		std::uint64_t _next_ticket = 0;
+	};
+}
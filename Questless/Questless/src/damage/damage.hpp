@@ -5,6 +5,8 @@
 
 #include "cancel/quantity.hpp"
 
+#include <array>
+#include <cstddef>
 #include <variant>
 
 namespace ql {
@@ -23,6 +25,13 @@ namespace ql {
 
 		using damage = std::variant<slash, pierce, cleave, bludgeon, scorch, freeze, shock, poison, rot>;
 
+		//! The number of types of damage.
+		constexpr std::size_t lane_count = std::variant_size_v<damage>;
+
+		//! An amount of each type of damage, or of protection against or a factor for each type, indexed by the type's
+		//! index in @p damage.
+		using lanes = std::array<int, lane_count>;
+
 		// Damage factors
 
 		using slash_factor = cancel::quantity<int, cancel::unit_t<struct slash_factor_tag>>;
@@ -4,8 +4,6 @@
 #include "group.hpp"
 #include "damage.hpp"
 
-#include "utility/visitation.hpp"
-
 namespace ql::dmg {
 	auto group::against(armor const& armor) const -> group {
 		group result = *this;
@@ -13,48 +11,194 @@ namespace ql::dmg {
 		// Return the damage unmodified if the armor was bypassed.
 		if (result.bypass.get() > armor.coverage.get()) { return result; }
 
-		for (auto& part : result.parts) {
-			// Apply protection if not bypassed.
-			match(
-				part,
-				[&](slash& slash) { slash -= armor.protect.slash.get(); },
-				[&](pierce& pierce) { pierce -= armor.protect.pierce.get(); },
-				[&](cleave& cleave) { cleave -= armor.protect.cleave.get(); },
-				[&](bludgeon& bludgeon) { bludgeon -= armor.protect.bludgeon.get(); },
-				[&](scorch& scorch) { scorch -= armor.protect.scorch.get(); },
-				[&](freeze& freeze) { freeze -= armor.protect.freeze.get(); },
-				[&](shock& shock) { shock -= armor.protect.shock.get(); },
-				[&](poison& poison) { poison -= armor.protect.poison.get(); },
-				[&](rot& rot) { rot -= armor.protect.rot.get(); });
-			// Apply vulnerability and resistance.
+		lanes const protect = armor.protect.to_lanes();
+		lanes const resist = armor.resist.to_lanes();
+		lanes const vuln = armor.vuln.to_lanes();
+		// Apply protection, then vulnerability and resistance as percentages, in one branch-free pass over the lanes.
+		// Absent types of damage stay at zero.
+		for (std::size_t lane = 0; lane < lane_count; ++lane) {
+			int const is_present = static_cast<int>((present >> lane) & 1u);
+			int const protected_amount = amounts[lane] - protect[lane];
+			int const multiplied_amount = protected_amount + protected_amount * (vuln[lane] - resist[lane]) / 100;
+			result.amounts[lane] = is_present * multiplied_amount;
+		}
+		return result;
+	}
+}
+
+#include "doctest_wrapper/test.hpp"
+
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace {
+	using namespace ql;
+	using namespace ql::dmg;
+
+	//! The alternative of @p Variant at index @p lane, holding @p amount.
+	template <typename Variant>
+	auto in_lane(std::size_t lane, int amount) -> Variant {
+		Variant result;
+		auto const set_lane = [&]<std::size_t Lane>(std::integral_constant<std::size_t, Lane>) {
+			if (lane == Lane) { result = Variant{std::in_place_index<Lane>, amount}; }
+		};
+		[&]<std::size_t... Lanes>(std::index_sequence<Lanes...>) {
+			(set_lane(std::integral_constant<std::size_t, Lanes>{}), ...);
+		}(std::make_index_sequence<std::variant_size_v<Variant>>{});
+		return result;
+	}
+
+	//! The parts of @p damage.
+	auto parts_of(group const& damage) -> std::vector<dmg::damage> {
+		std::vector<dmg::damage> result;
+		damage.for_each_part([&](dmg::damage const& part) { result.push_back(part); });
+		return result;
+	}
+
+	//! @p parts after going through @p armor, resolved part by part as groups were before they were stored in lanes.
+	auto reference_against(std::vector<damage> parts, coverage bypass, armor const& armor) -> std::vector<damage> {
+		if (bypass > armor.coverage.get()) { return parts; }
+		for (auto& part : parts) {
 			match(
 				part,
 				[&](slash& slash) {
+					slash -= armor.protect.slash.get();
 					slash += slash * (armor.vuln.slash.get() - armor.resist.slash.get()) / 100_slash_factor;
 				},
 				[&](pierce& pierce) {
+					pierce -= armor.protect.pierce.get();
 					pierce += pierce * (armor.vuln.pierce.get() - armor.resist.pierce.get()) / 100_pierce_factor;
 				},
 				[&](cleave& cleave) {
+					cleave -= armor.protect.cleave.get();
 					cleave += cleave * (armor.vuln.cleave.get() - armor.resist.cleave.get()) / 100_cleave_factor;
 				},
 				[&](bludgeon& bludgeon) {
-					bludgeon += bludgeon * (armor.vuln.bludgeon.get() - armor.resist.bludgeon.get()) / 100_bludgeon_factor;
+					bludgeon -= armor.protect.bludgeon.get();
+					bludgeon +=
+						bludgeon * (armor.vuln.bludgeon.get() - armor.resist.bludgeon.get()) / 100_bludgeon_factor;
 				},
 				[&](scorch& scorch) {
+					scorch -= armor.protect.scorch.get();
 					scorch += scorch * (armor.vuln.scorch.get() - armor.resist.scorch.get()) / 100_scorch_factor;
 				},
 				[&](freeze& freeze) {
+					freeze -= armor.protect.freeze.get();
 					freeze += freeze * (armor.vuln.freeze.get() - armor.resist.freeze.get()) / 100_freeze_factor;
 				},
 				[&](shock& shock) {
+					shock -= armor.protect.shock.get();
 					shock += shock * (armor.vuln.shock.get() - armor.resist.shock.get()) / 100_shock_factor;
 				},
 				[&](poison& poison) {
+					poison -= armor.protect.poison.get();
 					poison += poison * (armor.vuln.poison.get() - armor.resist.poison.get()) / 100_poison_factor;
 				},
-				[&](rot& rot) { rot += rot * (armor.vuln.rot.get() - armor.resist.rot.get()) / 100_rot_factor; });
+				[&](rot& rot) {
+					rot -= armor.protect.rot.get();
+					rot += rot * (armor.vuln.rot.get() - armor.resist.rot.get()) / 100_rot_factor;
+				});
 		}
-		return result;
+		return parts;
+	}
+}
+
+TEST_CASE("[group] resolution against armor") {
+	using namespace ql;
+	using namespace ql::dmg;
+
+	SUBCASE("protection, then vulnerability and resistance, truncated") {
+		armor armor;
+		armor.protect = protect{3_slash};
+		armor.resist = resist{factor{25_slash_factor}};
+		// 10 - 3 = 7, then 7 - 7 * 25 / 100 = 7 - 1.
+		CHECK(parts_of(group{10_slash}.against(armor)) == std::vector<damage>{6_slash});
+
+		armor.resist = resist{};
+		armor.vuln = vuln{factor{50_slash_factor}};
+		// 7 + 7 * 50 / 100 = 7 + 3.
+		CHECK(parts_of(group{10_slash}.against(armor)) == std::vector<damage>{10_slash});
+
+		// Protection can take damage below zero, which multipliers then scale, truncating toward zero.
+		armor.protect = protect{12_slash};
+		CHECK(parts_of(group{10_slash}.against(armor)) == std::vector<damage>{-3_slash});
+	}
+	SUBCASE("bypass versus coverage") {
+		armor armor;
+		armor.protect = protect{5_pierce};
+		armor.coverage = 50.0_coverage;
+		// Bypass must exceed coverage to skip the armor.
+		CHECK(parts_of(group{8_pierce, 60.0_coverage}.against(armor)) == std::vector<damage>{8_pierce});
+		CHECK(parts_of(group{8_pierce, 50.0_coverage}.against(armor)) == std::vector<damage>{3_pierce});
+		CHECK(parts_of(group{8_pierce}.against(armor)) == std::vector<damage>{3_pierce});
+	}
+	SUBCASE("absent types stay absent and zero") {
+		armor armor;
+		armor.protect = protect{5_rot};
+		armor.vuln = vuln{factor{200_rot_factor}};
+		auto const result = group{4_scorch}.against(armor);
+		CHECK(parts_of(result) == std::vector<damage>{4_scorch});
+		for (std::size_t lane = 0; lane < lane_count; ++lane) {
+			if (lane != damage{0_scorch}.index()) { CHECK_EQ(result.amounts[lane], 0); }
+		}
+	}
+	SUBCASE("matches resolving each part") {
+		// One part of one type at a time, so the lanes and the parts hold the same damage.
+		for (std::size_t lane = 0; lane < lane_count; ++lane) {
+			for (int const amount : {0, 1, 7, 10, 33}) {
+				for (int const protection : {0, 3, 12}) {
+					for (int const vuln_factor : {0, 50, 150}) {
+						for (int const resist_factor : {0, 25, 100}) {
+							for (double const bypass : {0.0, 60.0}) {
+								armor armor;
+								armor.protect =
+									std::visit([](auto p) { return protect{p}; }, in_lane<damage>(lane, protection));
+								armor.vuln = vuln{in_lane<factor>(lane, vuln_factor)};
+								armor.resist = resist{in_lane<factor>(lane, resist_factor)};
+								armor.coverage = 50.0_coverage;
+								auto const part = in_lane<damage>(lane, amount);
+								CHECK(parts_of(group{part, coverage{bypass}}.against(armor)) ==
+									reference_against({part}, coverage{bypass}, armor));
+							}
+						}
+					}
+				}
+			}
+		}
+		// Several types at once.
+		armor armor;
+		armor.protect = protect{2_cleave} + protect{1_shock};
+		armor.vuln = vuln{factor{30_cleave_factor}};
+		armor.resist = resist{factor{40_poison_factor}};
+		std::vector<damage> const parts{9_slash, 11_cleave, 5_shock, 17_poison};
+		CHECK(parts_of(group{9_slash, 11_cleave, 5_shock, 17_poison}.against(armor)) ==
+			reference_against(parts, 0.0_coverage, armor));
+	}
+}
+
+TEST_CASE("[group] construction and addition") {
+	using namespace ql;
+	using namespace ql::dmg;
+
+	SUBCASE("same types are summed on construction") {
+		group const damage{3_slash, 2_pierce, 4_slash};
+		CHECK(parts_of(damage) == std::vector<dmg::damage>{7_slash, 2_pierce});
+
+		// Armor applies once to the sum rather than once per part, so summed damage can resolve differently than the
+		// same parts resolved separately: 7 - 2 = 5 here, versus (3 - 2) + (4 - 2) = 3.
+		armor armor;
+		armor.protect = protect{2_slash};
+		CHECK(parts_of(damage.against(armor)) == std::vector<dmg::damage>{5_slash, 2_pierce});
+	}
+	SUBCASE("addition sums lanes and keeps the bypass") {
+		group damage{3_slash, 10.0_coverage};
+		damage += group{{2_slash, 4_scorch}, 50.0_coverage};
+		CHECK(parts_of(damage) == std::vector<dmg::damage>{5_slash, 4_scorch});
+		CHECK_EQ(damage.bypass.get(), 10.0_coverage);
+
+		// Types present with no damage are still present.
+		damage += group{0_rot};
+		CHECK(parts_of(damage) == std::vector<dmg::damage>{5_slash, 4_scorch, 0_rot});
 	}
 }
@@ -10,39 +10,78 @@
 #include "utility/visitation.hpp"
 
 #include <cmath>
-#include <vector>
+#include <cstdint>
+#include <initializer_list>
+#include <type_traits>
+#include <utility>
 
 namespace ql::dmg {
 	//! Represents a single group of damage to a being, possibly including multiple types and quantities of damage and
-	//! protection bypass.
+	//! protection bypass. Stored as a fixed array with one lane per type of damage, so groups never allocate.
 	struct group {
-		//! The different parts/components of the damage group.
-		std::vector<damage> parts{};
+		//! The amount of each type of damage in this group, indexed by the type's index in @p damage.
+		lanes amounts{};
+
+		//! The types of damage present in this group, as bits indexed like @p amounts. Damage can be present with a
+		//! non-positive amount, e.g. after it's been reduced by armor.
+		std::uint16_t present = 0;
 
 		//! The amount of coverage this group can bypass.
 		static_bounded<coverage, min_coverage, max_coverage> bypass = 0.0_coverage;
 
 		group() = default;
 
-		//! Constructs a damage group from a list of damage components.
+		//! Constructs a damage group from a list of damage components. Components of the same type are summed.
 		//! @param parts The list of components in this damage group.
 		//! @param bypass The amount of coverage this group can bypass.
-		group(std::vector<damage> parts, coverage bypass = 0.0_coverage) : parts{std::move(parts)}, bypass{bypass} {}
+		group(std::initializer_list<damage> parts, coverage bypass = 0.0_coverage) : bypass{bypass} {
+			for (auto const& part : parts) {
+				add(part);
+			}
+		}
 
 		//! Constructs a damage group from a single damage component.
 		//! @param part The single component of this damage group.
 		//! @param bypass The amount of coverage this group can bypass.
-		group(damage damage, coverage bypass = 0.0_coverage) : parts{{damage}}, bypass{bypass} {}
+		group(damage damage, coverage bypass = 0.0_coverage) : bypass{bypass} {
+			add(damage);
+		}
+
+		//! Adds @p damage to the amount of its type in this group.
+		auto add(damage const& damage) -> void {
+			std::visit([&](auto const& part) { amounts[damage.index()] += part.data; }, damage);
+			present = static_cast<std::uint16_t>(present | (1u << damage.index()));
+		}
+
+		//! Performs @p f on each type of damage present in this group, as a @p damage, in type order.
+		template <typename F>
+		auto for_each_part(F&& f) const -> void {
+			auto const visit_lane = [&]<std::size_t Lane>(std::integral_constant<std::size_t, Lane>) {
+				if (((present >> Lane) & 1u) != 0) { f(damage{std::in_place_index<Lane>, amounts[Lane]}); }
+			};
+			[&]<std::size_t... Lanes>(std::index_sequence<Lanes...>) {
+				(visit_lane(std::integral_constant<std::size_t, Lanes>{}), ...);
+			}(std::make_index_sequence<lane_count>{});
+		}
+
+		//! Adds the damage in @p that to this group, keeping this group's bypass.
+		auto& operator+=(group const& that) {
+			for (std::size_t lane = 0; lane < lane_count; ++lane) {
+				amounts[lane] += that.amounts[lane];
+			}
+			present = static_cast<std::uint16_t>(present | that.present);
+			return *this;
+		}
 
 		auto& operator*=(int k) {
-			for (auto& part : parts) {
-				std::visit([k](auto& part) { part *= k; }, part);
+			for (auto& amount : amounts) {
+				amount *= k;
 			}
 			return *this;
 		}
 		auto& operator/=(int k) {
-			for (auto& part : parts) {
-				std::visit([k](auto& part) { part /= k; }, part);
+			for (auto& amount : amounts) {
+				amount /= k;
 			}
 			return *this;
 		}
@@ -58,6 +58,19 @@ namespace ql::dmg {
 				[this](rot_factor f) { rot = f; });
 		}
 
+		//! The factor for each type of damage, indexed like @p damage.
+		constexpr auto to_lanes() const -> lanes {
+			return {slash.get().data,
+				pierce.get().data,
+				cleave.get().data,
+				bludgeon.get().data,
+				scorch.get().data,
+				freeze.get().data,
+				shock.get().data,
+				poison.get().data,
+				rot.get().data};
+		}
+
 		auto& operator+=(Derived const& d) {
 			slash += d.slash;
 			pierce += d.pierce;
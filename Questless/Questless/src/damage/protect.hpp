@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include "damage.hpp"
+
 #include "bounded/nonnegative.hpp"
 #include "bounded/static.hpp"
 
@@ -40,6 +42,19 @@ namespace ql {
 			constexpr protect(dmg::poison poison) : poison{poison} {}
 			constexpr protect(dmg::rot rot) : rot{rot} {}
 
+			//! The protection against each type of damage, indexed like @p damage.
+			constexpr auto to_lanes() const -> lanes {
+				return {slash.get().data,
+					pierce.get().data,
+					cleave.get().data,
+					bludgeon.get().data,
+					scorch.get().data,
+					freeze.get().data,
+					shock.get().data,
+					poison.get().data,
+					rot.get().data};
+			}
+
 			auto& operator+=(protect const& p) {
 				slash += p.slash;
 				pierce += p.pierce;
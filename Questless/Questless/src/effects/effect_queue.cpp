@@ -0,0 +1,94 @@
+//! @file
+//! @copyright See <a href="LICENSE.txt">LICENSE.txt</a>.
+
+#include "effect_queue.hpp"
+
+#include <algorithm>
+
+namespace ql::effects {
+	namespace {
+		//! Adds the damage of @p next to @p prev if both are injuries that differ only in their damage amounts.
+		//! @return Whether @p next was merged into @p prev.
+		auto try_coalesce(effect& prev, effect const& next) -> bool {
+			auto const prev_injury = std::get_if<injury>(&prev.value);
+			auto const next_injury = std::get_if<injury>(&next.value);
+			if (prev_injury == nullptr || next_injury == nullptr) { return false; }
+			if (prev_injury->target_being_id != next_injury->target_being_id ||
+				prev_injury->target_part_idx != next_injury->target_part_idx ||
+				prev_injury->o_source_id != next_injury->o_source_id || prev_injury->origin != next_injury->origin ||
+				prev_injury->damage.bypass.get() != next_injury->damage.bypass.get()) {
+				return false;
+			}
+
+			// Sum the damage of each type.
+			auto damage = prev_injury->damage;
+			damage += next_injury->damage;
+			injury merged{prev_injury->origin,
+				damage,
+				prev_injury->target_being_id,
+				prev_injury->target_part_idx,
+				prev_injury->o_source_id};
+			prev.value.emplace<injury>(std::move(merged));
+			return true;
+		}
+	}
+
+	effect_queue::effect_queue(effect_queue&& that) noexcept : _effects{std::move(that._effects)} {}
+
+	auto effect_queue::operator=(effect_queue&& that) noexcept -> effect_queue& {
+		_effects = std::move(that._effects);
+		return *this;
+	}
+
+	auto effect_queue::push(id emitter_id, effect effect) -> void {
+		std::scoped_lock lock{_mutex};
+		_effects.emplace_back(emitter_id, std::move(effect));
+	}
+
+	auto effect_queue::take() -> std::vector<effect> {
+		std::vector<std::pair<id, effect>> effects;
+		{
+			std::scoped_lock lock{_mutex};
+			std::swap(effects, _effects);
+		}
+		// Effects from the same emitter were pushed in program order, so a stable sort by emitter is deterministic.
+		std::stable_sort(effects.begin(), effects.end(), [](auto const& left, auto const& right) {
+			return left.first < right.first;
+		});
+		std::vector<effect> result;
+		result.reserve(effects.size());
+		for (std::size_t i = 0; i < effects.size(); ++i) {
+			auto& [emitter_id, effect] = effects[i];
+			if (i > 0 && effects[i - 1].first == emitter_id && try_coalesce(result.back(), effect)) { continue; }
+			result.push_back(std::move(effect));
+		}
+		return result;
+	}
+}
+
+#include "doctest_wrapper/test.hpp"
+
+TEST_CASE("[effect_queue] coalescing") {
+	using namespace ql;
+	using namespace ql::effects;
+
+	reg reg;
+	id const emitter_id = reg.create();
+	id const other_being_id = reg.create();
+	tile_hex_point const origin{0_pace, 0_pace};
+
+	effect_queue queue;
+	queue.push(emitter_id, {injury{origin, dmg::group{2_slash}, emitter_id, 0, std::nullopt}});
+	queue.push(emitter_id, {injury{origin, dmg::group{3_slash}, emitter_id, 0, std::nullopt}});
+	// Same part index and emitter, but a different body.
+	queue.push(emitter_id, {injury{origin, dmg::group{4_slash}, other_being_id, 0, std::nullopt}});
+	// A different part of the first body.
+	queue.push(emitter_id, {injury{origin, dmg::group{5_slash}, emitter_id, 1, std::nullopt}});
+
+	auto const taken = queue.take();
+	REQUIRE_EQ(taken.size(), 3u);
+	CHECK_EQ(std::get<injury>(taken[0].value).target_being_id, emitter_id);
+	CHECK_EQ(std::get<injury>(taken[1].value).target_being_id, other_being_id);
+	CHECK_EQ(std::get<injury>(taken[2].value).target_part_idx, 1u);
+	CHECK(queue.take().empty());
+}
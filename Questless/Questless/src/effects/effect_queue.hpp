@@ -0,0 +1,39 @@
+//! @file
+//! @copyright See <a href="LICENSE.txt">LICENSE.txt</a>.
+
+#pragma once
+
+#include "effect.hpp"
+
+#include "reg.hpp"
+
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace ql::effects {
+	//! Effects waiting to be added to a region. Effects may be queued from several threads at once, but are always
+	//! taken in the same order for the same set of emitters.
+	struct effect_queue {
+		effect_queue() = default;
+
+		//! Moves the queued effects of @p that. Not safe while @p that is being pushed to.
+		effect_queue(effect_queue&& that) noexcept;
+
+		//! Moves the queued effects of @p that. Not safe while either queue is being pushed to.
+		auto operator=(effect_queue&& that) noexcept -> effect_queue&;
+
+		//! Queues @p effect, emitted by the entity @p emitter_id. Safe to call concurrently.
+		auto push(id emitter_id, effect effect) -> void;
+
+		//! Removes and returns the queued effects, ordered by emitter ID and then by the order each emitter queued
+		//! them. Each emitter pushes from one thread at a time, so the order doesn't depend on how threads interleaved.
+		//! Consecutive injuries an emitter queued to the same part of the same body from the same source at the same
+		//! place are coalesced into one, so that bursts of damage reach perceivers as a single effect.
+		auto take() -> std::vector<effect>;
+
+	private:
+		std::mutex _mutex;
+		std::vector<std::pair<id, effect>> _effects;
+	};
+}
@@ -6,6 +6,7 @@
 #include "damage/group.hpp"
 #include "world/coordinates.hpp"
 
+#include <cstddef>
 #include <optional>
 
 namespace ql {
@@ -16,7 +17,8 @@ namespace ql {
 			tile_hex_point origin;
 			dmg::group const damage;
 			id target_being_id;
-			id target_part_id;
+			//! The index of the injured part in the target's body.
+			std::size_t target_part_idx;
 			std::optional<id> o_source_id;
 
 			constexpr auto range() const -> pace {
@@ -6,132 +6,147 @@
 #include "being.hpp"
 #include "body_part.hpp"
 
+#include "utility/clamped_ramp.hpp"
 #include "utility/utility.hpp"
 
+#include <cstdint>
 #include <numeric>
-#include <queue>
 
 namespace ql {
-	namespace {
-		auto reset_stats(body& b) -> void {
-			b.stats.reset();
-			// Aggregate part stats.
-			b.for_enabled_parts([&](body_part const& part) { b.stats.a.combine_with(part.stats.a); });
-			// Apply condition effects.
-			if (b.cond.weary()) { b.stats.a.strength.cur /= 2; }
-			if (b.cond.sleepy()) { b.stats.a.intellect.cur /= 2; }
-		}
-
-		template <typename ConstQualifiedBodyPartType, typename F>
-		auto for_parts_impl(reg& reg, body const& body, bool include_disabled, F const& f) -> void {
-			std::queue<id> work_list;
-			work_list.push(body.root_part_id);
-			while (!work_list.empty()) {
-				// Get the next part from the work list.
-				id part_id = work_list.front();
-				ConstQualifiedBodyPartType part = reg.get<body_part>(part_id);
-				// Check ableness condition before proceeding into this branch.
-				if (include_disabled || part.cond.enabled()) {
-					// Apply the function.
-					f(part);
-					// Add any children of the current part to the work list.
-					for (auto const& attachment : part.attachments) {
-						if (attachment.o_part_id) { work_list.push(*attachment.o_part_id); }
-					}
-				}
-				// Pop the current part from the work list.
-				work_list.pop();
-			}
-		}
-	}
-
-	body::body(ql::reg& reg, ql::id id, ql::id root_part_id, body_cond cond, stats::body stats)
+	body::body(ql::reg& reg, ql::id id, generators::generator const& root_generator, body_cond cond, stats::body stats)
 		: reg{&reg}
 		, id{id}
-		, root_part_id{root_part_id}
 		, cond{std::move(cond)}
 		, stats{std::move(stats)} //
 	{
-		reset_stats(*this);
-	}
+		// Generate the parts breadth-first, appending each part's children to the end of the parts as it's reached.
+		auto root = root_generator.make(reg, id);
+		parts.push_back(std::move(root.part));
+		std::vector<std::vector<generators::generator>> attachment_generators{std::move(root.attachment_generators)};
+		for (std::size_t part_idx = 0; part_idx < parts.size(); ++part_idx) {
+			auto generators = std::move(attachment_generators[part_idx]);
+			parts[part_idx].idx = part_idx;
+			parts[part_idx].first_attachment_idx = attachments.size();
+			parts[part_idx].attachment_count = generators.size();
+			for (auto& generator : generators) {
+				auto child = generator.make(reg, id);
+				child.part.o_parent_idx = part_idx;
+				attachments.push_back({parts.size(), std::move(generator)});
+				parts.push_back(std::move(child.part));
+				attachment_generators.push_back(std::move(child.attachment_generators));
+			}
+		}
 
-	auto body::for_all_parts(std::function<void(body_part const&)> const& f) const -> void {
-		for_parts_impl<body_part const&>(*reg, *this, true, f);
-	}
-	auto body::for_all_parts(std::function<void(body_part&)> const& f) -> void {
-		for_parts_impl<body_part&>(*reg, *this, true, f);
+		refresh_stats(cond.thresholds());
 	}
 
-	auto body::for_enabled_parts(std::function<void(body_part const&)> const& f) const -> void {
-		for_parts_impl<body_part const&>(*reg, *this, false, f);
+	auto body::connected(body_part const& part) const -> bool {
+		// Parents precede their children, so this only ever steps backward through the parts.
+		for (body_part const* p = &part; p->cond.enabled(); p = &parts[*p->o_parent_idx]) {
+			if (!p->o_parent_idx) { return true; }
+		}
+		return false;
 	}
-	auto body::for_enabled_parts(std::function<void(body_part&)> const& f) -> void {
-		for_parts_impl<body_part&>(*reg, *this, false, f);
+
+	auto body::refresh_stats(body_cond::threshold_mask thresholds) -> void {
+		thresholds = static_cast<body_cond::threshold_mask>(thresholds & stat_thresholds);
+		if (!_stats_dirty && thresholds == _aggregated_thresholds) { return; }
+
+		stats.reset();
+		// Aggregate part stats.
+		for_enabled_parts([&](body_part const& part) { stats.a.combine_with(part.stats.a); });
+		// Apply condition effects.
+		if (thresholds & body_cond::weary_bit) { stats.a.strength.cur /= 2; }
+		if (thresholds & body_cond::sleepy_bit) { stats.a.intellect.cur /= 2; }
+
+		_aggregated_thresholds = thresholds;
+		_stats_dirty = false;
 	}
 
 	auto body::update(tick elapsed) -> void {
-		// Reset and aggregate stats.
-		reset_stats(*this);
-
-		// Update conditions.
-		cond.satiety -= (cond.awake() ? 0.05_sat : 0.025_sat) / 1_tick * elapsed;
-		cond.energy += (cond.awake() ? 1_ep : 3_ep) / 1_tick * elapsed;
-		cond.alertness += (cond.awake() ? -0.1_alert : 0.2_alert) / 1_tick * elapsed;
-
-		// Bleed and regenerate blood.
-		for_all_parts([&](body_part const& part) {
-			// Intermediate blood values may leave the valid range.
-			cond.blood += (part.stats.blood_regen() - part.stats.bleeding.cur) * elapsed;
-		});
-		// After all blood contributions have been added, clamp blood into the valid region.
-		cond.blood = std::clamp(cond.blood, 0.0_blood, stats.a.max_blood());
+		cond.drift(elapsed);
+		update_drifted(elapsed, cond.thresholds());
+	}
+
+	auto body::update_drifted(tick elapsed, body_cond::threshold_mask thresholds) -> void {
+		// Reaggregate stats if needed.
+		refresh_stats(thresholds);
+
+		// Everything below is computed in closed form, so updating by many ticks at once costs no more than updating by
+		// one. Updating by n ticks matches n one-tick updates, except near the bounds of conditions that rise and fall
+		// within a tick, and except that one-tick updates truncate integral vitality loss every tick.
+		std::int64_t const n = elapsed.data;
+
+		// Bleed and regenerate blood. The net rate is constant, so blood changes linearly until it hits a bound.
+		auto blood_rate = 0.0_blood_per_tick;
+		for_all_parts([&](body_part const& part) { blood_rate += part.stats.blood_regen() - part.stats.bleeding.cur; });
+		auto const max_blood = stats.a.max_blood();
+		double const initial_pct_blood_lost = 1.0 - (cond.blood / max_blood);
+		cond.blood = std::clamp(cond.blood + blood_rate * elapsed, 0.0_blood, max_blood);
 
 		{ // Handle blood loss.
 			constexpr double stage_1_max = 0.15;
 			constexpr double stage_2_max = 0.3;
 			constexpr double stage_3_max = 0.4;
 
-			double const pct_blood_lost = 1.0 - (cond.blood / stats.a.max_blood());
+			// After k ticks, the fraction of blood lost is clamp(initial_pct_blood_lost + k * pct_lost_per_tick, 0, 1).
+			// A stage's effects scale with how far past the stage's start that is, from 0 at the start to 1 when all
+			// blood is lost, which is a ramp in k.
+			double const pct_lost_per_tick = -(blood_rate * 1_tick / max_blood);
+			auto const stage_ramp = [&](double stage_start) {
+				return clamped_ramp{(initial_pct_blood_lost - stage_start) / (1.0 - stage_start),
+					pct_lost_per_tick / (1.0 - stage_start)};
+			};
 
 			// No effects for stage 1 blood loss.
-			if (pct_blood_lost > stage_1_max) {
-				// Stage 2: anxiety.
+
+			{ // Stage 2: anxiety.
+				// Stage-2 severity summed over the elapsed ticks.
+				double const stage_2_ticks = stage_ramp(stage_1_max).sum(n);
 
 				// Joy loss as a factor of stage-2 blood loss.
 				constexpr auto joy_loss_rate = 1.0_joy / 1_tick;
-				cond.joy -= (pct_blood_lost - stage_1_max) / (1.0 - stage_1_max) * joy_loss_rate * elapsed;
+				cond.joy -= stage_2_ticks * joy_loss_rate * 1_tick;
 
 				// Courage loss as a factor of stage-2 blood loss.
 				constexpr auto courage_loss_rate = 1.0_courage / 1_tick;
-				cond.courage -= (pct_blood_lost - stage_1_max) / (1.0 - stage_1_max) * courage_loss_rate * elapsed;
+				cond.courage -= stage_2_ticks * courage_loss_rate * 1_tick;
 			}
-			if (pct_blood_lost > stage_2_max) {
-				// Stage 3: confusion.
+			{ // Stage 4: lethargy, loss of consciousness, damage.
+				auto const stage_4 = stage_ramp(stage_3_max);
+				// Stage-4 severity summed over the elapsed ticks.
+				double const stage_4_ticks = stage_4.sum(n);
 
-				// Intellect reduction as a factor of stage-3 blood loss.
-				constexpr auto intellect_loss_rate = 50_int;
-				stats.a.intellect.cur -= cancel::quantity_cast<intellect>(
-					(pct_blood_lost - stage_2_max) / (1.0 - stage_2_max) * intellect_loss_rate);
-			}
-			if (pct_blood_lost > stage_3_max) {
-				// Stage 4: lethargy, loss of consciousness, damage.
-
-				double const pct_stage_4_blood_lost = (pct_blood_lost - stage_3_max) / (1.0 - stage_3_max);
-
-				// Energy loss as a factor of stage-4 blood loss.
+				// Energy loss as a factor of stage-4 blood loss. Energy is integral, so it's only lost during ticks
+				// with total blood loss.
 				constexpr auto energy_loss_rate = 1_ep / 1_tick;
-				cond.energy -= cancel::quantity_cast<energy>(pct_stage_4_blood_lost * energy_loss_rate * elapsed);
+				auto const total_loss_ticks = static_cast<int>(n - stage_4.count_below(1.0, n));
+				cond.energy -= energy_loss_rate * (total_loss_ticks * 1_tick);
 
 				// Alertness loss as a factor of stage-4 blood loss.
 				constexpr auto alertness_loss_rate = 1.0_alert / 1_tick;
-				cond.alertness -= pct_stage_4_blood_lost * alertness_loss_rate * elapsed;
-
-				// Reduce vitality in proportion to stage-4 blood loss.
-				constexpr auto decay_rate = 1_decay / 1_tick;
-				for_all_parts([&](body_part& part) {
-					part.stats.a.vitality.cur -= cancel::quantity_cast<health>(
-						part.stats.a.vitality.base * pct_stage_4_blood_lost);
-				});
+				cond.alertness -= stage_4_ticks * alertness_loss_rate * 1_tick;
+
+				// Reduce vitality in proportion to stage-4 blood loss over the elapsed time.
+				if (stage_4_ticks > 0.0) {
+					for_all_parts([&](body_part& part) {
+						part.stats.a.vitality.cur -=
+							cancel::quantity_cast<health>(part.stats.a.vitality.base * stage_4_ticks);
+					});
+					// Reaggregate now so that mortality reflects the lost vitality.
+					invalidate_stats();
+					refresh_stats(cond.thresholds());
+				}
+			}
+			{ // Stage 3: confusion. Unlike the other stages, this only depends on the current blood loss.
+				double const stage_3_severity = stage_ramp(stage_2_max).at(n);
+				if (stage_3_severity > 0.0) {
+					// Intellect reduction as a factor of stage-3 blood loss.
+					constexpr auto intellect_loss_rate = 50_int;
+					stats.a.intellect.cur -= cancel::quantity_cast<intellect>(stage_3_severity * intellect_loss_rate);
+					// The reduction is based on the current blood loss, so it should only last until the next update.
+					invalidate_stats();
+				}
 			}
 		}
 
@@ -161,3 +176,120 @@ namespace ql {
 		}
 	}
 }
+
+#include "doctest_wrapper/test.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+TEST_CASE("[body] multi-tick updates match one-tick updates") {
+	using namespace ql;
+
+	reg reg;
+	auto const root_generator = generators::generator{generators::human::torso{}};
+
+	// Makes a human body with @p initial_pct_blood_lost of its blood lost, bleeding @p pct_bled_per_tick of its blood
+	// per tick.
+	auto const make_bleeding_body = [&](double initial_pct_blood_lost, double pct_bled_per_tick) {
+		body result{reg, reg.create(), root_generator, body_cond{}, generators::human::make_body_stats()};
+		auto const max_blood = result.stats.a.max_blood();
+		result.cond.blood = (1.0 - initial_pct_blood_lost) * max_blood;
+		// Keep energy clear of its bounds, where clamping every tick differs from clamping once.
+		result.cond.energy = 10_ep;
+		// Without regeneration, blood falls at the bleeding rate.
+		result.for_all_parts([](body_part& part) { part.stats.regen_factor.cur = 0; });
+		result.root_part().stats.bleeding.cur = pct_bled_per_tick * max_blood / 1_tick;
+		return result;
+	};
+
+	// Advances two identical bodies, one by @p n ticks at once and one by @p n one-tick updates, and checks that they
+	// agree. Energy must match exactly. Vitality may differ by at most one point per part for each tick of partial
+	// stage-4 blood loss, since one-tick updates truncate each tick's loss. Returns the body that was stepped.
+	auto const check_against_steps = [&](double initial_pct_blood_lost, double pct_bled_per_tick, int n) {
+		body multi = make_bleeding_body(initial_pct_blood_lost, pct_bled_per_tick);
+		body stepped = make_bleeding_body(initial_pct_blood_lost, pct_bled_per_tick);
+
+		multi.update(n * 1_tick);
+		int partial_stage_4_tick_count = 0;
+		for (int i = 0; i < n; ++i) {
+			stepped.update(1_tick);
+			double const pct_blood_lost = 1.0 - stepped.cond.blood / stepped.stats.a.max_blood();
+			double const stage_4_severity = (pct_blood_lost - 0.4) / 0.6;
+			if (0.0 < stage_4_severity && stage_4_severity < 1.0) { ++partial_stage_4_tick_count; }
+		}
+
+		CHECK_EQ(multi.cond.blood.data, doctest::Approx(stepped.cond.blood.data));
+		CHECK_EQ(multi.cond.energy.get().data, stepped.cond.energy.get().data);
+		CHECK_EQ(multi.cond.alertness.get().data, doctest::Approx(stepped.cond.alertness.get().data));
+		CHECK_EQ(multi.cond.joy.get().data, doctest::Approx(stepped.cond.joy.get().data));
+		CHECK_EQ(multi.cond.courage.get().data, doctest::Approx(stepped.cond.courage.get().data));
+		REQUIRE_EQ(multi.parts.size(), stepped.parts.size());
+		for (std::size_t idx = 0; idx < multi.parts.size(); ++idx) {
+			auto const multi_vitality = multi.parts[idx].stats.a.vitality.cur;
+			auto const stepped_vitality = stepped.parts[idx].stats.a.vitality.cur;
+			CHECK_LE(std::abs((multi_vitality - stepped_vitality).data), partial_stage_4_tick_count);
+		}
+		return stepped;
+	};
+
+	SUBCASE("crossing stages 2, 3 and 4") {
+		// From 10% to about 71% lost, crossing 15%, 30% and 40% between ticks.
+		auto const stepped = check_against_steps(0.1, 0.0153, 40);
+		double const pct_blood_lost = 1.0 - stepped.cond.blood / stepped.stats.a.max_blood();
+		CHECK_GT(pct_blood_lost, 0.4);
+		CHECK_LT(pct_blood_lost, 1.0);
+	}
+	SUBCASE("blood bottoming out") {
+		// From 50% lost, running out of blood during the 22nd tick.
+		auto const stepped = check_against_steps(0.5, 0.0237, 40);
+		CHECK_EQ(stepped.cond.blood, 0.0_blood);
+	}
+	SUBCASE("already out of blood") {
+		auto const stepped = check_against_steps(1.0, 0.01, 20);
+		CHECK_EQ(stepped.cond.blood, 0.0_blood);
+	}
+}
+
+TEST_CASE("[body] enabled parts are those connected to the root") {
+	using namespace ql;
+
+	reg reg;
+	body human_body{reg,
+		reg.create(),
+		generators::generator{generators::human::torso{}},
+		body_cond{},
+		generators::human::make_body_stats()};
+	REQUIRE_GT(human_body.parts.size(), 2u);
+
+	auto const enabled_part_indices = [&] {
+		std::vector<std::size_t> result;
+		human_body.for_enabled_parts([&](body_part const& part) { result.push_back(part.idx); });
+		return result;
+	};
+	auto const connected_part_indices = [&] {
+		std::vector<std::size_t> result;
+		human_body.for_all_parts([&](body_part const& part) {
+			if (human_body.connected(part)) { result.push_back(part.idx); }
+		});
+		return result;
+	};
+
+	CHECK_EQ(enabled_part_indices().size(), human_body.parts.size());
+
+	// Disable a part attached to the root, cutting off everything attached through it, and the last part.
+	human_body.parts[1].cond.ableness = ableness::disabled;
+	human_body.parts.back().cond.ableness = ableness::disabled;
+	auto const enabled = enabled_part_indices();
+	CHECK_EQ(enabled, connected_part_indices());
+	CHECK_LT(enabled.size(), human_body.parts.size() - 1);
+	for (auto const& part : human_body.parts) {
+		if (part.o_parent_idx == std::size_t{1}) {
+			CHECK_EQ(std::find(enabled.begin(), enabled.end(), part.idx), enabled.end());
+		}
+	}
+
+	// A disabled root disables the whole human_body.
+	human_body.root_part().cond.ableness = ableness::disabled;
+	CHECK(enabled_part_indices().empty());
+}
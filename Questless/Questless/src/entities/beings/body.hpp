@@ -3,46 +3,131 @@
 
 #pragma once
 
+#include "attachment.hpp"
 #include "body_cond.hpp"
+#include "body_part.hpp"
+#include "body_part_generator.hpp"
 #include "body_status_set.hpp"
 #include "stats/body.hpp"
 
 #include "quantities/misc.hpp"
 #include "reg.hpp"
 
-#include <functional>
+#include <span>
+#include <vector>
 
 namespace ql {
-	struct body_part;
-
 	//! A being's body, which is composed of a tree of body parts.
 	struct body {
 		reg_ptr reg;
 
 		id id;
 
-		//! The ID of the root body part, to which all other body parts are attached.
-		ql::id root_part_id;
+		//! This body's parts, in breadth-first order from the root part, to which all other body parts are attached.
+		//! Each part comes after its parent, and the parts attached to a given part are contiguous.
+		std::vector<body_part> parts;
+
+		//! The attachment points of all this body's parts, grouped by part. See @p attachments_of.
+		std::vector<attachment> attachments;
 
 		body_cond cond;
 
+		//! The body's stats, aggregated from its enabled parts and modified by its conditions. These are cached between
+		//! updates and only recomputed once invalidated. See @p invalidate_stats.
 		stats::body stats;
 
 		body_status_set status_set;
 
-		body(ql::reg& reg, ql::id id, ql::id root_part_id, body_cond cond, stats::body stats);
+		//! @param root_generator Generates the root part. The rest of the parts are generated from the default
+		//! generators of the root's attachments, recursively.
+		body(ql::reg& reg, ql::id id, generators::generator const& root_generator, body_cond cond, stats::body stats);
+
+		//! The root body part.
+		auto root_part() -> body_part& {
+			return parts.front();
+		}
+
+		//! The attachment points on @p part, which must be one of this body's parts.
+		auto attachments_of(body_part const& part) -> std::span<attachment> {
+			return {attachments.data() + part.first_attachment_idx, part.attachment_count};
+		}
+		//! The attachment points on @p part, which must be one of this body's parts.
+		auto attachments_of(body_part const& part) const -> std::span<attachment const> {
+			return {attachments.data() + part.first_attachment_idx, part.attachment_count};
+		}
+
+		//! Whether @p part and every part between it and the root are enabled. Walks the parent chain of @p part, so
+		//! use @p for_enabled_parts to visit every connected part.
+		auto connected(body_part const& part) const -> bool;
 
 		//! Performs @p f for each body part in this body. See also @p for_enabled_parts.
-		auto for_all_parts(std::function<void(body_part const&)> const& f) const -> void;
+		template <typename F>
+		auto for_all_parts(F&& f) const -> void {
+			for (body_part const& part : parts) {
+				f(part);
+			}
+		}
 		//! Performs @p f for each body part in this body. See also @p for_enabled_parts.
-		auto for_all_parts(std::function<void(body_part&)> const& f) -> void;
+		template <typename F>
+		auto for_all_parts(F&& f) -> void {
+			for (body_part& part : parts) {
+				f(part);
+			}
+		}
+
+		//! Performs @p f for each enabled body part in this body, skipping parts attached through disabled parts. See
+		//! also @p for_all_parts.
+		template <typename F>
+		auto for_enabled_parts(F&& f) const -> void {
+			for_connected_parts(*this, f);
+		}
+		//! Performs @p f for each enabled body part in this body, skipping parts attached through disabled parts. See
+		//! also @p for_all_parts.
+		template <typename F>
+		auto for_enabled_parts(F&& f) -> void {
+			for_connected_parts(*this, f);
+		}
 
-		//! Performs @p f for each enabled body part in this body. See also @p for_all_parts.
-		auto for_enabled_parts(std::function<void(body_part const&)> const& f) const -> void;
-		//! Performs @p f for each enabled body part in this body. See also @p for_all_parts.
-		auto for_enabled_parts(std::function<void(body_part&)> const& f) -> void;
+		//! Marks this body's aggregated stats out of date, so that they're recomputed on the next update. Call after
+		//! changing the stats of any of this body's parts, enabling or disabling a part, changing equipment, or
+		//! modifying @p stats in a way that should only last until the next update.
+		auto invalidate_stats() -> void {
+			_stats_dirty = true;
+		}
 
-		//! Advances this body and all its parts by @p elapsed.
+		//! Advances this body and all its parts by @p elapsed, in constant time, so that bodies that haven't been updated
+		//! for a while, e.g. from resting or being far from any observer, can catch up in one call.
 		auto update(tick elapsed) -> void;
+
+		//! Like @p update, but for when @p cond has already been drifted by @p elapsed, e.g. by a @p body_cond_batch.
+		//! @param thresholds The thresholds of @p cond after drifting.
+		auto update_drifted(tick elapsed, body_cond::threshold_mask thresholds) -> void;
+
+	private:
+		//! The condition thresholds that modify the aggregated stats.
+		static constexpr body_cond::threshold_mask stat_thresholds =
+			body_cond::weary_bit | body_cond::sleepy_bit;
+
+		bool _stats_dirty = true;
+
+		//! The body's @p stat_thresholds when its stats were last aggregated.
+		body_cond::threshold_mask _aggregated_thresholds = 0;
+
+		//! Performs @p f for each part of @p self that's @p connected, in one forward pass. Parents precede their
+		//! children, so whether a part's parent is connected is known by the time the part is reached.
+		template <typename Self, typename F>
+		static auto for_connected_parts(Self& self, F& f) -> void {
+			std::vector<bool> reachable(self.parts.size());
+			for (std::size_t idx = 0; idx < self.parts.size(); ++idx) {
+				auto& part = self.parts[idx];
+				reachable[idx] = part.cond.enabled() && (!part.o_parent_idx || reachable[*part.o_parent_idx]);
+				if (reachable[idx]) { f(part); }
+			}
+		}
+
+		//! Recomputes @p stats if they've been invalidated or if the body has crossed a condition threshold that
+		//! modifies them.
+		//! @param thresholds The current thresholds of @p cond.
+		auto refresh_stats(body_cond::threshold_mask thresholds) -> void;
 	};
 }
@@ -5,10 +5,13 @@
 
 #include "bounded/nonnegative.hpp"
 #include "bounded/static.hpp"
+#include "quantities/game_time.hpp"
 #include "quantities/misc.hpp"
 #include "reg.hpp"
 #include "world/coordinates.hpp"
 
+#include <cstdint>
+
 namespace ql {
 	enum class mortality : int { alive = 0, dead, undead, immortal };
 
@@ -16,22 +19,26 @@ namespace ql {
 	struct body_cond {
 		static constexpr auto min_energy = 0_ep;
 		static constexpr auto max_energy = 100_ep;
+		static constexpr auto weary_energy = min_energy + (max_energy - min_energy) / 4;
+		static constexpr auto energized_energy = min_energy + 3 * (max_energy - min_energy) / 4;
 		static_bounded<ql::energy, min_energy, max_energy> energy;
 		constexpr auto weary() const -> bool {
-			return energy.get() < min_energy + (max_energy - min_energy) / 4;
+			return energy.get() < weary_energy;
 		}
 		constexpr auto energized() const -> bool {
-			return energy.get() > min_energy + 3 * (max_energy - min_energy) / 4;
+			return energy.get() > energized_energy;
 		}
 
 		static constexpr auto min_satiety = 0.0_sat;
 		static constexpr auto max_satiety = 100.0_sat;
+		static constexpr auto hungry_satiety = min_satiety + (max_satiety - min_satiety) / 4;
+		static constexpr auto full_satiety = min_satiety + 3 * (max_satiety - min_satiety) / 4;
 		static_bounded<ql::satiety, min_satiety, max_satiety> satiety = max_satiety;
 		constexpr auto hungry() const -> bool {
-			return satiety.get() < min_satiety + (max_satiety - min_satiety) / 4;
+			return satiety.get() < hungry_satiety;
 		}
 		constexpr auto full() const -> bool {
-			return satiety.get() > min_satiety + 3 * (max_satiety - min_satiety) / 4;
+			return satiety.get() > full_satiety;
 		}
 		constexpr auto starving() const -> bool {
 			return satiety.get() == min_satiety;
@@ -39,12 +46,41 @@ namespace ql {
 
 		static constexpr auto min_alertness = 0.0_alert;
 		static constexpr auto max_alertness = 100.0_alert;
+		static constexpr auto sleepy_alertness = min_alertness + (max_alertness - min_alertness) / 4;
+		static constexpr auto alert_alertness = min_alertness + 3 * (max_alertness - min_alertness) / 4;
 		static_bounded<ql::alertness, min_alertness, max_alertness> alertness = max_alertness;
 		constexpr auto sleepy() const -> bool {
-			return alertness.get() < min_alertness + (max_alertness - min_alertness) / 4;
+			return alertness.get() < sleepy_alertness;
 		}
 		constexpr auto alert() const -> bool {
-			return alertness.get() > min_alertness + 3 * (max_alertness - min_alertness) / 4;
+			return alertness.get() > alert_alertness;
+		}
+
+		//! The rates at which energy, satiety, and alertness drift while awake and while asleep.
+		static constexpr auto awake_energy_rate = 1_ep / 1_tick;
+		static constexpr auto asleep_energy_rate = 3_ep / 1_tick;
+		static constexpr auto awake_satiety_rate = -0.05_sat / 1_tick;
+		static constexpr auto asleep_satiety_rate = -0.025_sat / 1_tick;
+		static constexpr auto awake_alertness_rate = -0.1_alert / 1_tick;
+		static constexpr auto asleep_alertness_rate = 0.2_alert / 1_tick;
+
+		//! Bits of a @p threshold_mask, one for each threshold predicate on energy, satiety, and alertness.
+		enum threshold_bit : std::uint8_t {
+			weary_bit = 1 << 0,
+			energized_bit = 1 << 1,
+			hungry_bit = 1 << 2,
+			full_bit = 1 << 3,
+			starving_bit = 1 << 4,
+			sleepy_bit = 1 << 5,
+			alert_bit = 1 << 6
+		};
+		using threshold_mask = std::uint8_t;
+
+		//! The threshold predicates on energy, satiety, and alertness that are currently true.
+		constexpr auto thresholds() const -> threshold_mask {
+			return static_cast<threshold_mask>((weary() ? weary_bit : 0) | (energized() ? energized_bit : 0) |
+				(hungry() ? hungry_bit : 0) | (full() ? full_bit : 0) | (starving() ? starving_bit : 0) |
+				(sleepy() ? sleepy_bit : 0) | (alert() ? alert_bit : 0));
 		}
 
 		static constexpr auto min_joy = -100.0_joy;
@@ -79,6 +115,9 @@ namespace ql {
 
 		hex_direction direction = hex_direction::dr;
 
+		//! How long the body is occupied by the actions it performed this turn, delaying its next turn.
+		tick busy_time = 0_tick;
+
 		ql::awakeness awakeness = awakeness::awake;
 		constexpr auto awake() const -> bool {
 			return awakeness == awakeness::awake;
@@ -90,5 +129,13 @@ namespace ql {
 		ql::blood blood = 0.0_blood;
 
 		ql::mortality mortality = ql::mortality::alive;
+
+		//! Advances energy, satiety, and alertness by @p elapsed at their drift rates. See also @p body_cond_batch,
+		//! which does this for many bodies at once.
+		auto drift(tick elapsed) -> void {
+			energy += (awake() ? awake_energy_rate : asleep_energy_rate) * elapsed;
+			satiety += (awake() ? awake_satiety_rate : asleep_satiety_rate) * elapsed;
+			alertness += (awake() ? awake_alertness_rate : asleep_alertness_rate) * elapsed;
+		}
 	};
 }
@@ -0,0 +1,128 @@
+//! @file
+//! @copyright See <a href="LICENSE.txt">LICENSE.txt</a>.
+
+#include "body_cond_batch.hpp"
+
+#include <algorithm>
+
+namespace ql {
+	namespace {
+		//! Sets @p result to the thresholds of each body with the given energy, satiety, and alertness.
+		auto evaluate_thresholds(std::vector<int> const& energy,
+			std::vector<double> const& satiety,
+			std::vector<double> const& alertness,
+			std::vector<body_cond::threshold_mask>& result) -> void //
+		{
+			result.resize(energy.size());
+			for (std::size_t i = 0; i < energy.size(); ++i) {
+				result[i] = static_cast<body_cond::threshold_mask>(
+					(energy[i] < body_cond::weary_energy.data ? body_cond::weary_bit : 0) |
+					(energy[i] > body_cond::energized_energy.data ? body_cond::energized_bit : 0) |
+					(satiety[i] < body_cond::hungry_satiety.data ? body_cond::hungry_bit : 0) |
+					(satiety[i] > body_cond::full_satiety.data ? body_cond::full_bit : 0) |
+					(satiety[i] == body_cond::min_satiety.data ? body_cond::starving_bit : 0) |
+					(alertness[i] < body_cond::sleepy_alertness.data ? body_cond::sleepy_bit : 0) |
+					(alertness[i] > body_cond::alert_alertness.data ? body_cond::alert_bit : 0));
+			}
+		}
+	}
+
+	auto body_cond_batch::push_back(body_cond const& cond, tick elapsed) -> void {
+		_energy.push_back(cond.energy.get().data);
+		_satiety.push_back(cond.satiety.get().data);
+		_alertness.push_back(cond.alertness.get().data);
+		_elapsed.push_back(elapsed.data);
+		_awake.push_back(cond.awake() ? 1 : 0);
+	}
+
+	auto body_cond_batch::clear() -> void {
+		_energy.clear();
+		_satiety.clear();
+		_alertness.clear();
+		_elapsed.clear();
+		_awake.clear();
+		_thresholds.clear();
+	}
+
+	auto body_cond_batch::advance() -> void {
+		// These match body_cond::drift exactly. Each loop is kept to one condition so that it vectorizes.
+		for (std::size_t i = 0; i < _energy.size(); ++i) {
+			int const rate = _awake[i] ? body_cond::awake_energy_rate.data : body_cond::asleep_energy_rate.data;
+			_energy[i] = std::clamp(
+				_energy[i] + rate * _elapsed[i], body_cond::min_energy.data, body_cond::max_energy.data);
+		}
+		for (std::size_t i = 0; i < _satiety.size(); ++i) {
+			double const rate = _awake[i] ? body_cond::awake_satiety_rate.data : body_cond::asleep_satiety_rate.data;
+			_satiety[i] = std::clamp(
+				_satiety[i] + rate * _elapsed[i], body_cond::min_satiety.data, body_cond::max_satiety.data);
+		}
+		for (std::size_t i = 0; i < _alertness.size(); ++i) {
+			double const rate =
+				_awake[i] ? body_cond::awake_alertness_rate.data : body_cond::asleep_alertness_rate.data;
+			_alertness[i] = std::clamp(
+				_alertness[i] + rate * _elapsed[i], body_cond::min_alertness.data, body_cond::max_alertness.data);
+		}
+
+		evaluate_thresholds(_energy, _satiety, _alertness, _thresholds);
+	}
+
+	auto body_cond_batch::store(std::size_t idx, body_cond& cond) const -> void {
+		cond.energy = energy{_energy[idx]};
+		cond.satiety = satiety{_satiety[idx]};
+		cond.alertness = alertness{_alertness[idx]};
+	}
+}
+
+#include "doctest_wrapper/test.hpp"
+
+TEST_CASE("[body_cond_batch] matches body_cond::drift") {
+	using namespace ql;
+
+	// Conditions at and next to each clamp bound, awake and asleep.
+	std::vector<body_cond> conds;
+	for (auto const awakeness_value : {awakeness::awake, awakeness::asleep}) {
+		for (auto const energy_value : {body_cond::min_energy,
+				 body_cond::min_energy + 1_ep,
+				 body_cond::weary_energy,
+				 body_cond::max_energy - 1_ep,
+				 body_cond::max_energy}) {
+			for (auto const satiety_value : {body_cond::min_satiety,
+					 body_cond::min_satiety + 0.01_sat,
+					 body_cond::max_satiety - 0.01_sat,
+					 body_cond::max_satiety}) {
+				for (auto const alertness_value : {body_cond::min_alertness,
+						 body_cond::min_alertness + 0.05_alert,
+						 body_cond::max_alertness - 0.05_alert,
+						 body_cond::max_alertness}) {
+					body_cond cond;
+					cond.awakeness = awakeness_value;
+					cond.energy = energy_value;
+					cond.satiety = satiety_value;
+					cond.alertness = alertness_value;
+					conds.push_back(cond);
+				}
+			}
+		}
+	}
+
+	for (auto const elapsed : {0_tick, 1_tick, 3_tick, 1'000_tick}) {
+		body_cond_batch batch;
+		for (auto const& cond : conds) {
+			batch.push_back(cond, elapsed);
+		}
+		batch.advance();
+		REQUIRE_EQ(batch.size(), conds.size());
+
+		for (std::size_t idx = 0; idx < conds.size(); ++idx) {
+			body_cond expected = conds[idx];
+			expected.drift(elapsed);
+			body_cond actual = conds[idx];
+			batch.store(idx, actual);
+
+			CHECK_EQ(actual.energy.get().data, expected.energy.get().data);
+			CHECK_EQ(actual.satiety.get().data, expected.satiety.get().data);
+			CHECK_EQ(actual.alertness.get().data, expected.alertness.get().data);
+			CHECK_EQ(static_cast<int>(batch.thresholds(idx)), static_cast<int>(expected.thresholds()));
+		}
+	}
+}
@@ -0,0 +1,50 @@
+//! @file
+//! @copyright See <a href="LICENSE.txt">LICENSE.txt</a>.
+
+#pragma once
+
+#include "body_cond.hpp"
+
+#include "quantities/game_time.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ql {
+	//! Drifts the conditions of many bodies at once, as in @p body_cond::drift, and evaluates their thresholds. The
+	//! conditions are copied into parallel arrays so the drift, clamping, and threshold tests run as branch-free loops
+	//! over contiguous data, which the compiler can vectorize.
+	struct body_cond_batch {
+		//! Adds @p cond to the batch, to be advanced by @p elapsed.
+		auto push_back(body_cond const& cond, tick elapsed) -> void;
+
+		//! Removes all conditions from the batch, keeping its storage for reuse.
+		auto clear() -> void;
+
+		//! The number of conditions in the batch.
+		auto size() const -> std::size_t {
+			return _energy.size();
+		}
+
+		//! Drifts each condition by its elapsed time and updates its thresholds.
+		auto advance() -> void;
+
+		//! Writes the drifted energy, satiety, and alertness of the condition at @p idx back to @p cond.
+		auto store(std::size_t idx, body_cond& cond) const -> void;
+
+		//! The thresholds of the condition at @p idx after the last @p advance.
+		auto thresholds(std::size_t idx) const -> body_cond::threshold_mask {
+			return _thresholds[idx];
+		}
+
+	private:
+		std::vector<int> _energy;
+		std::vector<double> _satiety;
+		std::vector<double> _alertness;
+		std::vector<int> _elapsed;
+		//! Whether each body is awake, as 0 or 1 so that it can be used arithmetically.
+		std::vector<std::uint8_t> _awake;
+		std::vector<body_cond::threshold_mask> _thresholds;
+	};
+}
@@ -7,22 +7,7 @@
 #include "entities/beings/being.hpp"
 #include "world/region.hpp"
 
-#include <range/v3/view/transform.hpp>
-
 namespace ql {
-	namespace {
-		auto generate_attached_parts_helper(reg& reg, id part_id) -> void {
-			auto const& part = reg.get<body_part>(part_id);
-			auto const n = part.attachments.size();
-			auto const owner_id = part.owner_id;
-			for (size_t i = 0; i < n; ++i) {
-				auto const attached_part_id = reg.get<body_part>(part_id).attachments[i].default_generator.make(reg, owner_id);
-				generate_attached_parts_helper(reg, attached_part_id);
-				reg.get<body_part>(part_id).attachments[i].o_part_id = attached_part_id;
-			}
-		}
-	}
-
 	auto body_part::update(tick elapsed) -> void {
 		body& owner = reg->get<body>(owner_id);
 
@@ -59,7 +44,7 @@ namespace ql {
 		}
 	}
 
-	auto body_part::take_damage(dmg::group& damage, std::optional<ql::id> o_source_id) -> void {
+	auto body_part::take_damage(dmg::group& damage, std::optional<id> o_source_id) -> void {
 		// Apply part's equipped item's armor.
 		if (equipped_item_id) {
 			if (auto armor = reg->try_get<dmg::armor>(*equipped_item_id)) { damage = damage.against(*armor); }
@@ -72,7 +57,7 @@ namespace ql {
 
 		// Apply secondary damage effects.
 		//! @todo Add effects for other damage types. Balance numbers.
-		for (dmg::damage const& damage_part : damage.parts) {
+		damage.for_each_part([&](dmg::damage const& damage_part) {
 			match(
 				damage_part,
 				[&](dmg::slash const& s) { status_set.wounds.push_back(wound{s * 1_laceration / 1_slash}); },
@@ -93,14 +78,11 @@ namespace ql {
 				[&](dmg::shock const& s) { status_set.wounds.push_back(wound{s * 1_burn / 1_shock}); },
 				[&](dmg::poison const&) {},
 				[&](dmg::rot const&) {});
-		}
+		});
 
 		// Add injury effect.
 		auto const location = reg->get<ql::location>(owner_id);
-		reg->get<region>(location.region_id).add_effect({effects::injury{location.coords, damage, owner_id, id, o_source_id}});
-	}
-
-	auto body_part::generate_attached_parts() -> void {
-		generate_attached_parts_helper(*reg, id);
+		reg->get<region>(location.region_id)
+			.add_effect(owner_id, {effects::injury{location.coords, damage, owner_id, idx, o_source_id}});
 	}
 }
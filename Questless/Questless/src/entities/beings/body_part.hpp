@@ -3,7 +3,6 @@
 
 #pragma once
 
-#include "attachment.hpp"
 #include "body_part_cond.hpp"
 #include "body_part_status_set.hpp"
 
@@ -17,28 +16,67 @@
 
 #include "vecx/angle.hpp"
 
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
 #include <optional>
-#include <string>
-#include <unordered_set>
-#include <vector>
+#include <string_view>
 
 namespace ql {
-	//! A being's body part.
+	//! A being's body part. Body parts are stored by value in their @p body.
 	struct body_part {
 		enum class tag : int { head = 0, torso, arm, hand, leg, foot, wing, tail };
 
-		reg_ptr reg;
+		//! A set of body part tags, stored as a bitmask.
+		struct tag_set {
+			constexpr tag_set() = default;
+
+			constexpr tag_set(std::initializer_list<tag> tags) {
+				for (auto const tag : tags) {
+					insert(tag);
+				}
+			}
+
+			//! Whether this set contains @p tag.
+			constexpr auto contains(tag tag) const -> bool {
+				return (_bits & bit(tag)) != 0;
+			}
+
+			//! Adds @p tag to this set.
+			constexpr auto insert(tag tag) -> void {
+				_bits |= bit(tag);
+			}
 
-		id id;
+		private:
+			std::uint8_t _bits = 0;
+
+			static constexpr auto bit(tag tag) -> std::uint8_t {
+				return static_cast<std::uint8_t>(1u << static_cast<int>(tag));
+			}
+		};
+
+		reg_ptr reg;
 
 		//! The ID of the being that owns this body part.
-		ql::id owner_id;
+		id owner_id;
 
-		//! The player-visisble name of this body part.
-		std::string name{};
+		//! This part's index in its body's parts.
+		std::size_t idx = 0;
+
+		//! The index of the part this one is attached to or nullopt if this is the root part.
+		std::optional<std::size_t> o_parent_idx = std::nullopt;
+
+		//! The index of this part's first attachment point in its body's attachments.
+		std::size_t first_attachment_idx = 0;
+
+		//! The number of attachment points on this part.
+		std::size_t attachment_count = 0;
+
+		//! The player-visisble name of this body part. Refers to static storage, such as a string literal.
+		std::string_view name{};
 
 		//! The tags that determine what kind of part this is.
-		std::unordered_set<tag> tags{};
+		tag_set tags{};
 
 		//! This body part's conditions.
 		body_part_cond cond{};
@@ -52,11 +90,8 @@ namespace ql {
 		//! The draw layer, with smaller-numbered layers drawn first (i.e. in the background).
 		int layer = 0;
 
-		//! The body part attachment points on this body part.
-		std::vector<attachment> attachments{};
-
 		//! The ID of the item equipped to this body or nullopt if none.
-		std::optional<ql::id> equipped_item_id = std::nullopt;
+		std::optional<id> equipped_item_id = std::nullopt;
 
 		//! Advances the body part by @p elapsed.
 		auto update(tick elapsed) -> void;
@@ -64,9 +99,6 @@ namespace ql {
 		//! Causes this part to take damage.
 		//! @param damage Damage to be applied to this part.
 		//! @param o_source_id The ID of the being which caused the damage, if any.
-		auto take_damage(dmg::group& damage, std::optional<ql::id> o_source_id) -> void;
-
-		//! Recursively generates each missing attached body part using default parts.
-		auto generate_attached_parts() -> void;
+		auto take_damage(dmg::group& damage, std::optional<id> o_source_id) -> void;
 	};
 }
@@ -14,12 +14,9 @@ namespace ql::generators {
 
 	// Generic body part template:
 	/*
-		auto ::make(id owner_id) const -> id {
-			id id = reg.create();
-			auto& part = reg.assign<body_part>(id);
+		auto ::make(reg& reg, id owner_id) const -> generated_part {
+			body_part part{&reg, owner_id};
 
-			part.id = id;
-			part.owner_id = owner_id;
 			part.name = "PART NAME";
 			part.tags = {body_part::tag::TAGS};
 			part.cond.action = {_ap, _ap};
@@ -48,15 +45,8 @@ namespace ql::generators {
 			part.stats.armor = {};
 
 			part.layer = 0;
-			part.attachments = {{
-				owner_id, // owner_id
-				std::nullopt, // o_part_id
-				sf::Vector2f{}, // offset
-				_rad, // rotation
-				{} // default_generator
-			}};
-
-			return id;
+
+			return {std::move(part), {generator{}}};
 		}
 	*/
 
@@ -65,9 +55,8 @@ namespace ql::generators {
 			return {};
 		}
 
-		auto torso::make(reg& reg, id owner_id) const -> id {
-			id id = reg.create();
-			auto& part = reg.assign<body_part>(id, &reg, id, owner_id);
+		auto torso::make(reg& reg, id owner_id) const -> generated_part {
+			body_part part{&reg, owner_id};
 
 			part.name = "human torso";
 			part.tags = {body_part::tag::torso};
@@ -83,44 +72,19 @@ namespace ql::generators {
 			part.stats.max_temp = 100_temp;
 
 			part.layer = 0;
-			part.attachments = {//
-				{
-					// Head
-					owner_id, // owner_id
-					std::nullopt, // o_part_id
-					{human::head{}} // default_generator
-				},
-				{
-					// Left arm
-					owner_id, // owner_id
-					std::nullopt, // o_part_id
-					{human::left_arm{}} // default_generator
-				},
-				{
-					// Right arm
-					owner_id, // owner_id
-					std::nullopt, // o_part_id
-					{human::right_arm{}} // default_generator
-				},
-				{
-					// Left leg
-					owner_id, // owner_id
-					std::nullopt, // o_part_id
-					{human::left_leg{}} // default_generator
-				},
+
+			return {std::move(part),
 				{
-					// Right leg
-					owner_id, // owner_id
-					std::nullopt, // o_part_id
-					{human::right_leg{}} // default_generator
+					generator{human::head{}},
+					generator{human::left_arm{}},
+					generator{human::right_arm{}},
+					generator{human::left_leg{}},
+					generator{human::right_leg{}},
 				}};
-
-			return id;
 		}
 
-		auto head::make(reg& reg, id owner_id) const -> id {
-			id id = reg.create();
-			auto& part = reg.assign<body_part>(id, &reg, id, owner_id);
+		auto head::make(reg& reg, id owner_id) const -> generated_part {
+			body_part part{&reg, owner_id};
 
 			part.name = "human head";
 			part.tags = {body_part::tag::head};
@@ -147,12 +111,11 @@ namespace ql::generators {
 
 			part.layer = 0;
 
-			return id;
+			return {std::move(part), {}};
 		}
 
-		auto make_arm(reg& reg, id owner_id, side side) -> id {
-			id id = reg.create();
-			auto& part = reg.assign<body_part>(id, &reg, id, owner_id);
+		auto make_arm(reg& reg, id owner_id, side side) -> generated_part {
+			body_part part{&reg, owner_id};
 
 			part.name = side == side::left ? "human left arm" : "human right arm";
 			part.tags = {body_part::tag::arm};
@@ -168,27 +131,21 @@ namespace ql::generators {
 			part.stats.max_temp = 100_temp;
 
 			part.layer = 0;
-			part.attachments = {{
-				// Hand
-				owner_id, // owner_id
-				std::nullopt, // o_part_id
-				side == side::left ? generator{human::left_hand{}} : generator{human::right_hand{}} // default_generator
-			}};
-
-			return id;
+
+			auto hand = side == side::left ? generator{human::left_hand{}} : generator{human::right_hand{}};
+			return {std::move(part), {std::move(hand)}};
 		}
 
-		auto left_arm::make(reg& reg, id owner_id) const -> id {
+		auto left_arm::make(reg& reg, id owner_id) const -> generated_part {
 			return make_arm(reg, owner_id, side::left);
 		}
 
-		auto right_arm::make(reg& reg, id owner_id) const -> id {
+		auto right_arm::make(reg& reg, id owner_id) const -> generated_part {
 			return make_arm(reg, owner_id, side::right);
 		}
 
-		auto make_hand(reg& reg, id owner_id, side side) -> id {
-			id id = reg.create();
-			auto& part = reg.assign<body_part>(id, &reg, id, owner_id);
+		auto make_hand(reg& reg, id owner_id, side side) -> generated_part {
+			body_part part{&reg, owner_id};
 
 			part.name = side == side::left ? "human left hand" : "human right hand";
 			part.tags = {body_part::tag::hand};
@@ -205,20 +162,19 @@ namespace ql::generators {
 
 			part.layer = 0;
 
-			return id;
+			return {std::move(part), {}};
 		}
 
-		auto left_hand::make(reg& reg, id owner_id) const -> id {
+		auto left_hand::make(reg& reg, id owner_id) const -> generated_part {
 			return make_hand(reg, owner_id, side::left);
 		}
 
-		auto right_hand::make(reg& reg, id owner_id) const -> id {
+		auto right_hand::make(reg& reg, id owner_id) const -> generated_part {
 			return make_hand(reg, owner_id, side::right);
 		}
 
-		auto make_leg(reg& reg, id owner_id, side side) -> id {
-			id id = reg.create();
-			auto& part = reg.assign<body_part>(id, &reg, id, owner_id);
+		auto make_leg(reg& reg, id owner_id, side side) -> generated_part {
+			body_part part{&reg, owner_id};
 
 			part.name = side == side::left ? "human left leg" : "human right leg";
 			part.tags = {body_part::tag::leg};
@@ -234,27 +190,21 @@ namespace ql::generators {
 			part.stats.max_temp = 100_temp;
 
 			part.layer = 0;
-			part.attachments = {{
-				// Foot
-				owner_id, // owner_id
-				std::nullopt, // o_part_id
-				side == side::left ? generator{human::left_foot{}} : generator{human::right_foot{}} // default_generator
-			}};
-
-			return id;
+
+			auto foot = side == side::left ? generator{human::left_foot{}} : generator{human::right_foot{}};
+			return {std::move(part), {std::move(foot)}};
 		}
 
-		auto left_leg::make(reg& reg, id owner_id) const -> id {
+		auto left_leg::make(reg& reg, id owner_id) const -> generated_part {
 			return make_leg(reg, owner_id, side::left);
 		}
 
-		auto right_leg::make(reg& reg, id owner_id) const -> id {
+		auto right_leg::make(reg& reg, id owner_id) const -> generated_part {
 			return make_leg(reg, owner_id, side::right);
 		}
 
-		auto make_foot(reg& reg, id owner_id, side side) -> id {
-			id id = reg.create();
-			auto& part = reg.assign<body_part>(id, &reg, id, owner_id);
+		auto make_foot(reg& reg, id owner_id, side side) -> generated_part {
+			body_part part{&reg, owner_id};
 
 			part.name = side == side::left ? "human left foot" : "human right foot";
 			part.tags = {body_part::tag::foot};
@@ -271,19 +221,19 @@ namespace ql::generators {
 
 			part.layer = 0;
 
-			return id;
+			return {std::move(part), {}};
 		}
 
-		auto left_foot::make(reg& reg, id owner_id) const -> id {
+		auto left_foot::make(reg& reg, id owner_id) const -> generated_part {
 			return make_foot(reg, owner_id, side::left);
 		}
 
-		auto right_foot::make(reg& reg, id owner_id) const -> id {
+		auto right_foot::make(reg& reg, id owner_id) const -> generated_part {
 			return make_foot(reg, owner_id, side::right);
 		}
 	}
 
-	auto generator::make(reg& reg, id owner_id) const -> id {
+	auto generator::make(reg& reg, id owner_id) const -> generated_part {
 		return match(value, [&](auto const& value) { //
 			return value.make(reg, owner_id);
 		});
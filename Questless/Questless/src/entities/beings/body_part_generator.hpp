@@ -3,45 +3,50 @@
 
 #pragma once
 
+#include "body_part.hpp"
+
 #include "reg.hpp"
 #include "stats/body.hpp"
 #include "utility/visitation.hpp"
 
 #include <variant>
+#include <vector>
 
 namespace ql::generators {
+	struct generated_part;
+
 	namespace human {
 		auto make_body_stats() -> stats::body;
 
 		struct torso {
-			auto make(reg& reg, id owner_id) const -> id;
+			auto make(reg& reg, id owner_id) const -> generated_part;
 		};
 		struct head {
-			auto make(reg& reg, id owner_id) const -> id;
+			auto make(reg& reg, id owner_id) const -> generated_part;
 		};
 		struct left_arm {
-			auto make(reg& reg, id owner_id) const -> id;
+			auto make(reg& reg, id owner_id) const -> generated_part;
 		};
 		struct right_arm {
-			auto make(reg& reg, id owner_id) const -> id;
+			auto make(reg& reg, id owner_id) const -> generated_part;
 		};
 		struct left_hand {
-			auto make(reg& reg, id owner_id) const -> id;
+			auto make(reg& reg, id owner_id) const -> generated_part;
 		};
 		struct right_hand {
-			auto make(reg& reg, id owner_id) const -> id;
+			auto make(reg& reg, id owner_id) const -> generated_part;
 		};
 		struct left_leg {
-			auto make(reg& reg, id owner_id) const -> id;
+			auto make(reg& reg, id owner_id) const -> generated_part;
 		};
 		struct right_leg {
-			auto make(reg& reg, id owner_id) const -> id;
+			auto make(reg& reg, id owner_id) const -> generated_part;
 		};
 		struct left_foot {
-			auto make(reg& reg, id owner_id) const -> id;
+			auto make(reg& reg, id owner_id) const -> generated_part;
 		};
 		struct right_foot {
-			auto make(reg& reg, id owner_id) const -> id;
+			auto make(reg& reg, id owner_id) const -> generated_part;
 		};
 	}
 
@@ -64,6 +69,6 @@ namespace ql::generators {
 		//! Generates a body part.
 		//! @param owner_id The ID of the being to own the new body part.
 		//! @return The ID of the new body part.
-		auto make(reg& reg, id owner_id) const -> id;
+		auto make(reg& reg, id owner_id) const -> generated_part;
 	};
 }
@@ -5,6 +5,7 @@
 
 #include "body_part_status_set.hpp"
 
+#include "body.hpp"
 #include "body_part.hpp"
 
 #include "entities/beings/stats/aggregate.hpp"
@@ -38,9 +39,7 @@ namespace ql {
 		}
 	}
 
-	auto body_part_status_set::apply(reg& reg, tick elapsed) -> void {
-		auto& part = reg.get<body_part>(id);
-
+	auto body_part_status_set::apply(body_part& part, tick elapsed) -> void {
 		// Apply permanent effects.
 		for (auto const& status : permanent) {
 			apply_status(part, status, elapsed);
@@ -90,6 +89,9 @@ namespace ql {
 				[&](frostbite& f) { f -= 1_frostbite * elapsed / 1_tick; });
 		}
 
+		// Wounds reduce vitality, which is aggregated into the owner's stats.
+		if (!wounds.empty()) { part.reg->get<body>(part.owner_id).invalidate_stats(); }
+
 		// Cap bleeding here, after aggregating all sources of bleeding.
 		part.stats.bleeding.cur = std::min(part.stats.bleeding.cur, part.stats.a.max_bleeding());
 	}
@@ -7,6 +7,8 @@
 #include "wounds.hpp"
 
 namespace ql {
+	struct body_part;
+
 	//! A status that expires after some time.
 	struct timed_body_part_status {
 		tick duration;
@@ -15,8 +17,6 @@ namespace ql {
 
 	//! Component for storing a being's status modifiers.
 	struct body_part_status_set {
-		id id;
-
 		//! Status modifiers that cannot be removed.
 		std::vector<body_part_status> permanent;
 
@@ -29,8 +29,8 @@ namespace ql {
 		//! Negative status modifiers that heal over time and then expire.
 		std::vector<wound> wounds;
 
-		//! Applies the effects of this status set to its being.
+		//! Applies the effects of this status set to its body part, @p part.
 		//! @param elapsed The elapsed turns since this was last applied.
-		auto apply(reg& reg, tick elapsed) -> void;
+		auto apply(body_part& part, tick elapsed) -> void;
 	};
 }
@@ -15,6 +15,8 @@
 namespace ql {
 	namespace {
 		auto apply_status(body& body, body_status status, tick /*elapsed*/) -> void {
+			// Statuses modify the aggregated stats directly, so they must be reaggregated before being reapplied.
+			body.invalidate_stats();
 			match(
 				status,
 				[&](blind const& b) {
@@ -5,16 +5,13 @@
 
 #include "being.hpp"
 #include "body.hpp"
-#include "body_part.hpp"
 #include "body_part_generator.hpp"
 
 namespace ql {
 	id make_human(reg& reg, id human_id, location location, agent agent) {
-		auto root_id = generators::human::torso{}.make(reg, human_id);
-		auto& root = reg.get<body_part>(root_id);
-		root.generate_attached_parts();
-
-		make_being(reg, human_id, location, agent, body{reg, human_id, root_id, body_cond{}, generators::human::make_body_stats()});
+		auto const root_generator = generators::generator{generators::human::torso{}};
+		body body{reg, human_id, root_generator, body_cond{}, generators::human::make_body_stats()};
+		make_being(reg, human_id, location, agent, std::move(body));
 
 		return human_id;
 	}
@@ -4,10 +4,12 @@
 #include "entities/beings/world_view.hpp"
 
 #include "entities/beings/being.hpp"
+#include "world/field_of_view.hpp"
 #include "world/hex_space.hpp"
 #include "world/region.hpp"
 
 #include <set>
+#include <vector>
 
 namespace ql {
 	world_view::world_view(ql::reg& reg, id viewer_id)
@@ -15,40 +17,54 @@ namespace ql {
 		, visual_range{max_visual_range(reg.get<body>(viewer_id).stats.a.vision_sources.cur)} //
 	{
 		auto& region = reg.get<ql::region>(center.region_id);
+		// Walk tiles with a cursor so that the section lookup is only repeated when crossing into another section.
+		auto cursor = region.cursor();
+		// Compute occlusion for the whole view at once rather than tracing a line to each tile.
+		field_of_view const fov{region, center.coords, visual_range};
 
-		// Iterate over the rhomboid specified by the location and visual range to find visible tiles and beings.
+		// Gather the loaded tiles within the hexagon specified by the location and visual range.
+		std::vector<tile_hex_point> tile_coords;
+		std::vector<terrain> tile_terrain;
 		for (pace q = -visual_range; q <= visual_range; ++q) {
 			for (pace r = -visual_range; r <= visual_range; ++r) {
 				auto const offset = tile_hex_vector{q, r};
 
 				// Skip corner tiles that are out of range.
 				if (offset.length() > visual_range) { continue; }
-				auto const tile_coords = center.coords + offset;
 
 				// Skip missing tiles.
-				auto const o_tile_id = region.tile_id_at(tile_coords);
-				if (!o_tile_id) { continue; }
-				auto const tile_id = *o_tile_id;
+				auto const o_tile = cursor.tile_at(center.coords + offset);
+				if (!o_tile) { continue; }
 
-				// Get tile perception and position.
-				auto const tile_perception = perception_of(reg, viewer_id, tile_coords);
-				auto const tile_position = tile_layout.to_world(tile_coords);
+				tile_coords.push_back(center.coords + offset);
+				tile_terrain.push_back(o_tile->terrain());
+			}
+		}
+
+		// Compute the perception of every tile in one batch.
+		std::vector<perception> tile_perceptions(tile_coords.size());
+		perceptions_of(perceptor_context{reg, viewer_id}, tile_coords, fov, tile_perceptions);
 
-				// Add tile view if perceptible.
-				if (tile_perception > 0_perception) { tile_views.push_back({tile_id, tile_perception, tile_position}); }
+		for (std::size_t i = 0; i < tile_coords.size(); ++i) {
+			auto const tile_perception = tile_perceptions[i];
+			auto const tile_position = tile_layout.to_world(tile_coords[i]);
+
+			// Add tile view if perceptible.
+			if (tile_perception > 0_perception) {
+				tile_views.push_back({tile_coords[i], tile_terrain[i], tile_perception, tile_position});
+			}
 
-				// Check for an entity on this tile.
-				auto const o_other_id = region.entity_id_at(tile_coords);
-				if (!o_other_id) { continue; }
-				auto const other_id = *o_other_id;
+			// Check for an entity on this tile.
+			auto const o_other_id = cursor.entity_id_at(tile_coords[i]);
+			if (!o_other_id) { continue; }
+			auto const other_id = *o_other_id;
 
-				// Can always perceive self fully. Otherwise perception of entity matches perception of tile.
-				auto const other_perception = other_id == viewer_id ? max_perception : tile_perception;
+			// Can always perceive self fully. Otherwise perception of entity matches perception of tile.
+			auto const other_perception = other_id == viewer_id ? max_perception : tile_perception;
 
-				// Add entity view if perceptible.
-				if (other_perception > 0_perception) {
-					entity_views.push_back({other_id, other_perception, tile_position});
-				}
+			// Add entity view if perceptible.
+			if (other_perception > 0_perception) {
+				entity_views.push_back({other_id, other_perception, tile_position});
 			}
 		}
 	}
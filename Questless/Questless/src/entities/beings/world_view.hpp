@@ -5,6 +5,7 @@
 
 #include "entities/perception.hpp"
 #include "world/coordinates.hpp"
+#include "world/terrain.hpp"
 #include "world/section.hpp"
 
 #include <array>
@@ -18,7 +19,9 @@ namespace ql {
 	//! Represents everything an agent can perceive about its being's environment.
 	struct world_view {
 		struct tile_view {
-			id id;
+			//! Tiles aren't entities, so they're identified by their coordinates.
+			tile_hex_point coords;
+			ql::terrain terrain;
 			perception perception;
 
 			// Position is included here (redundantly) for efficiency because it's required in various places.
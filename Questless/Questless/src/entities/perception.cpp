@@ -6,12 +6,16 @@
 #include "perception.hpp"
 
 #include "entities/beings/body.hpp"
+#include "world/field_of_view.hpp"
 #include "world/region.hpp"
 
 #include <range/v3/algorithm/max.hpp>
 #include <range/v3/view/transform.hpp>
 
+#include <algorithm>
+#include <cassert>
 #include <numeric>
+#include <vector>
 
 namespace ql {
 	namespace {
@@ -24,27 +28,6 @@ namespace ql {
 		return ranges::max(acuities) / perception_loss_per_pace;
 	}
 
-	//! Determines whether @p target is in the field of vision specified by @p location and @p direction.
-	auto inside_field_of_vision(location const& location, hex_direction direction, tile_hex_point target) -> bool {
-		auto offset = target - location.coords;
-		switch (direction) {
-			case hex_direction::dr:
-				return offset.q >= 0_pace && offset.q + offset.r >= 0_pace;
-			case hex_direction::d:
-				return offset.r >= 0_pace && offset.q + offset.r >= 0_pace;
-			case hex_direction::dl:
-				return offset.q <= 0_pace && offset.r >= 0_pace;
-			case hex_direction::ul:
-				return offset.q <= 0_pace && offset.q + offset.r <= 0_pace;
-			case hex_direction::u:
-				return offset.r <= 0_pace && offset.q + offset.r <= 0_pace;
-			case hex_direction::ur:
-				return offset.q >= 0_pace && offset.r <= 0_pace;
-			default:
-				UNREACHABLE;
-		}
-	}
-
 	//! Computes the perception @p vision is capable of, factoring in the @p illuminance.
 	auto light_adjusted_perception(stats::vision const& vision, lum illuminance) -> perception {
 		if (illuminance < vision.min_illuminance.get()) {
@@ -59,40 +42,167 @@ namespace ql {
 		}
 	}
 
+	perceptor_context::perceptor_context(reg& reg, id perceptor_id)
+		: location{reg.get<ql::location>(perceptor_id)}
+		, direction{reg.get<body>(perceptor_id).cond.direction}
+		, vision_sources{reg.get<body>(perceptor_id).stats.a.vision_sources.cur}
+		, visual_range{max_visual_range(reg.get<body>(perceptor_id).stats.a.vision_sources.cur)}
+		, region_ptr{&reg.get<region>(location.region_id)} //
+	{}
+
 	auto perception_of(reg& reg, id perceptor_id, tile_hex_point target) -> perception {
-		auto const& body = reg.get<ql::body>(perceptor_id);
+		perceptor_context const perceptor{reg, perceptor_id};
 
 		// Check that the perceptor has at least one source of vision.
-		if (body.stats.a.vision_sources.cur.empty()) { return 0_perception; }
-
-		auto const location = reg.get<ql::location>(perceptor_id);
+		if (perceptor.vision_sources.empty()) { return 0_perception; }
 
 		// Check that the target is within the field of vision.
-		if (!inside_field_of_vision(location, body.cond.direction, target)) { return 0_perception; }
+		if (!inside_field_of_vision(perceptor.location.coords, perceptor.direction, target)) { return 0_perception; }
 
 		// Check that the target within the maximum possible visual range.
-		if ((target - location.coords).length() > max_visual_range(body.stats.a.vision_sources.cur)) {
-			return 0_perception;
-		}
-
-		auto const& region = reg.get<ql::region>(location.region_id);
+		if ((target - perceptor.location.coords).length() > perceptor.visual_range) { return 0_perception; }
 
 		// Find the best possible visual perception, factoring in the light level at the target.
-		auto const illuminance = region.illuminance(target);
+		auto const illuminance = perceptor.region_ptr->illuminance(target);
 		auto const best_light_adjusted_perception = std::reduce( //
-			body.stats.a.vision_sources.cur.begin(),
-			body.stats.a.vision_sources.cur.end(),
+			perceptor.vision_sources.begin(),
+			perceptor.vision_sources.end(),
 			0_perception,
 			[&](perception acc, stats::vision v) { return std::max(acc, light_adjusted_perception(v, illuminance)); });
 
 		// Account for distance.
-		pace const distance = (target - location.coords).length();
+		pace const distance = (target - perceptor.location.coords).length();
 		auto const best_distance_adjusted_perception = best_light_adjusted_perception - distance * perception_loss_per_pace;
 
 		// Account for occlusions between the perceptor and the target.
-		double const occlusion = region.occlusion(location.coords, target);
+		double const occlusion = perceptor.region_ptr->occlusion(perceptor.location.coords, target);
 		auto const best_perception = cancel::quantity_cast<perception>((1.0 - occlusion) * best_distance_adjusted_perception);
 
 		return std::max(0_perception, best_perception);
 	}
+
+	auto perceptions_of(perceptor_context const& perceptor,
+		std::span<tile_hex_point const> targets,
+		field_of_view const& fov,
+		std::span<perception> perceptions) -> void //
+	{
+		assert(targets.size() == perceptions.size());
+		if (perceptor.vision_sources.empty()) {
+			std::fill(perceptions.begin(), perceptions.end(), 0_perception);
+			return;
+		}
+
+		// Gather the per-target inputs into packed arrays of raw values, so the loops below can be vectorized. Targets
+		// outside the field of vision or beyond visual range get zero visibility.
+		auto const n = targets.size();
+		std::vector<int> illuminances(n);
+		std::vector<int> distances(n);
+		std::vector<double> visibilities(n);
+		for (std::size_t i = 0; i < n; ++i) {
+			auto const distance = (targets[i] - perceptor.location.coords).length();
+			bool const visible = distance <= perceptor.visual_range &&
+				inside_field_of_vision(perceptor.location.coords, perceptor.direction, targets[i]);
+			illuminances[i] = perceptor.region_ptr->illuminance(targets[i]).data;
+			distances[i] = distance.data;
+			visibilities[i] = visible ? 1.0 - fov.occlusion_at(targets[i]) : 0.0;
+		}
+
+		// Find the best light-adjusted perception over all vision sources, as in light_adjusted_perception.
+		std::vector<int> best_perceptions(n, 0);
+		for (auto const& vision : perceptor.vision_sources) {
+			int const acuity = vision.acuity.get().data;
+			int const min_illuminance = vision.min_illuminance.get().data;
+			int const max_illuminance = vision.max_illuminance.get().data;
+			int const darkness_penalty = vision.darkness_penalty.get().data;
+			int const glare_penalty = vision.glare_penalty.get().data;
+			for (std::size_t i = 0; i < n; ++i) {
+				int const darkness = min_illuminance - illuminances[i];
+				int const glare = illuminances[i] - max_illuminance;
+				int const penalty = darkness > 0 ? darkness * darkness_penalty : glare > 0 ? glare * glare_penalty : 0;
+				best_perceptions[i] = std::max(best_perceptions[i], acuity - penalty);
+			}
+		}
+
+		// Account for distance and occlusion.
+		int const loss_per_pace = (perception_loss_per_pace * 1_pace).data;
+		for (std::size_t i = 0; i < n; ++i) {
+			int const distance_adjusted = best_perceptions[i] - distances[i] * loss_per_pace;
+			perceptions[i] = perception{std::max(0, static_cast<int>(visibilities[i] * distance_adjusted))};
+		}
+	}
 }
+
+#include "doctest_wrapper/test.hpp"
+
+#include "agents/agent.hpp"
+#include "entities/beings/human.hpp"
+
+TEST_CASE("[perception] batch and scalar paths agree") {
+	using namespace ql;
+
+	reg reg;
+	id const region_id = make_region(reg, reg.create(), "Region 1", 0);
+	auto& region = reg.get<ql::region>(region_id);
+	tile_hex_point const origin{0_pace, 0_pace};
+
+	// Clear the area. The two paths trace rays differently, so only unoccluded tiles or straight rays along the axes
+	// are guaranteed the same occlusion.
+	std::vector<id> generated_ids;
+	region.for_each_entity_within(
+		origin, 2 * section_diameter, [&](tile_hex_point, id entity_id) { generated_ids.push_back(entity_id); });
+	for (auto const entity_id : generated_ids) {
+		region.remove(entity_id);
+	}
+
+	id const perceptor_id = reg.create();
+	make_human(reg, perceptor_id, location{region_id, origin}, {basic_ai{reg, perceptor_id}});
+	REQUIRE(region.try_add(perceptor_id, origin));
+
+	// Checks that both paths agree on the perception of each target in the rhombus around the perceptor, a step beyond
+	// its visual range, that include accepts, in each direction the perceptor can face.
+	auto const check_agreement = [&](auto const& include) {
+		for (int direction = 0; direction < 6; ++direction) {
+			reg.get<body>(perceptor_id).cond.direction = static_cast<hex_direction>(direction);
+			perceptor_context const perceptor{reg, perceptor_id};
+			REQUIRE_GT(perceptor.visual_range, 0_pace);
+
+			std::vector<tile_hex_point> targets;
+			auto const extent = perceptor.visual_range + 1_pace;
+			for (pace q = -extent; q <= extent; ++q) {
+				for (pace r = -extent; r <= extent; ++r) {
+					auto const target = origin + tile_hex_vector{q, r};
+					if (include(target)) { targets.push_back(target); }
+				}
+			}
+			std::vector<perception> batch_perceptions(targets.size());
+			field_of_view const fov{region, origin, perceptor.visual_range};
+			perceptions_of(perceptor, targets, fov, batch_perceptions);
+
+			int perceived_count = 0;
+			for (std::size_t i = 0; i < targets.size(); ++i) {
+				CHECK_EQ(batch_perceptions[i], perception_of(reg, perceptor_id, targets[i]));
+				if (batch_perceptions[i] > 0_perception) { ++perceived_count; }
+			}
+			// Make sure the comparison isn't vacuous.
+			CHECK_GT(perceived_count, 0);
+		}
+	};
+
+	SUBCASE("unoccluded") {
+		check_agreement([](tile_hex_point) { return true; });
+	}
+	SUBCASE("occluded along the axes") {
+		// Put an occupant two tiles out in each direction, and check the tiles along each axis.
+		for (int direction = 0; direction < 6; ++direction) {
+			auto const coords = origin + 2 * tile_hex_vector::unit(static_cast<hex_direction>(direction));
+			id const occupant_id = reg.create();
+			make_human(reg, occupant_id, location{region_id, coords}, {basic_ai{reg, occupant_id}});
+			REQUIRE(region.try_add(occupant_id, coords));
+		}
+		check_agreement([&](tile_hex_point target) {
+			auto const offset = target - origin;
+			return offset.q == 0_pace || offset.r == 0_pace || offset.q + offset.r == 0_pace;
+		});
+	}
+}
+
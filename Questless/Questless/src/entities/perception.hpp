@@ -11,14 +11,39 @@
 
 #include "cancel/quantity.hpp"
 
+#include <span>
 #include <vector>
 
 namespace ql {
+	struct field_of_view;
+	struct region;
+
 	static constexpr auto max_perception = 100_perception;
 
 	//! The maximum possible distance a being with vision list @p vision_sources could see.
 	auto max_visual_range(std::vector<stats::vision> const& vision_sources) -> pace;
 
+	//! Everything about a perceptor needed to compute its perception of targets, gathered once per perceptor.
+	//! @note Refers to the perceptor's body and region, so it should not outlive the current update.
+	struct perceptor_context {
+		ql::location location;
+		hex_direction direction;
+		std::span<stats::vision const> vision_sources;
+		pace visual_range;
+		region const* region_ptr;
+
+		perceptor_context(reg& reg, id perceptor_id);
+	};
+
 	//! The nonnegative perception of the @p target tile by the being with ID @p perceptor_id.
 	auto perception_of(reg& reg, id perceptor_id, tile_hex_point target) -> perception;
+
+	//! Computes the nonnegative perception of each of @p targets by @p perceptor into the corresponding element of
+	//! @p perceptions, taking occlusion from @p fov, which should be seen from the perceptor's location.
+	//! @note Much cheaper per target than @p perception_of, since perceptor lookups happen once and the arithmetic runs
+	//! over packed arrays.
+	auto perceptions_of(perceptor_context const& perceptor,
+		std::span<tile_hex_point const> targets,
+		field_of_view const& fov,
+		std::span<perception> perceptions) -> void;
 }
@@ -13,11 +13,11 @@
 #include <fmt/format.h>
 #include <fmt/ostream.h>
 
-#include <numeric>
-#include <thread>
+#include <fstream>
+#include <string_view>
 
 namespace ql {
-	game::game(bool fullscreen) {
+	game::game(bool fullscreen, std::uint64_t world_seed, uptr<session_recorder> recorder) {
 		constexpr int _dflt_window_width = 1024;
 		constexpr int _dflt_window_height = 768;
 
@@ -31,7 +31,7 @@ namespace ql {
 		}
 
 		// Start on the splash screen.
-		_root = umake<splash>(_reg, _root, _fonts);
+		_root = umake<splash>(_reg, _root, _fonts, world_seed, std::move(recorder));
 
 		// Communicate the initial window size, and set position.
 		_root->on_parent_resize(view::vector_from_sfml(_window.getSize()));
@@ -92,61 +92,77 @@ namespace ql {
 				}
 			}
 			// Check if the game ended via an event.
-			if (_root == nullptr) { return; }
+			if (_root == nullptr) { break; }
 
 			// Update.
-			sec const elapsed_time = regulate_timing();
+			sec const elapsed_time = _pacer.wait();
+			auto const update_start = clock::now();
 			_root->update(elapsed_time);
+			sec const update_duration = to_sec(clock::now() - update_start);
 			// Check if the game ended via the update.
-			if (_root == nullptr) { return; }
+			if (_root == nullptr) { break; }
 
 			// Draw.
+			auto const draw_start = clock::now();
 			_window.clear();
 			_window.draw(*_root);
-			draw_fps();
+			draw_timings();
 			_window.display();
+			sec const draw_duration = to_sec(clock::now() - draw_start);
+
+			record_timings(elapsed_time, update_duration, draw_duration);
 		}
+		export_timings();
 	}
 
-	auto game::regulate_timing() -> sec {
-		// Determine how much time has actually passed since the last call.
-		sec frame_duration = to_sec(clock::now() - _last_update_time);
-		_last_update_time = clock::now();
-
-		auto time_deficit = frame_duration - target_frame_duration;
-		if (time_deficit > 0.0_s) {
-			// Over budget. Add to time debt.
-			_time_debt += time_deficit;
-		} else {
-			// Under budget. Pay some time debt and/or wait.
-			sec time_surplus = -time_deficit;
-			if (_time_debt < time_surplus) {
-				// Pay full debt.
-				time_surplus -= _time_debt.get();
-				_time_debt = 0.0_s;
-				// Sleep for remaining time surplus.
-				auto const sleep = std::chrono::duration_cast<std::chrono::milliseconds>(to_chrono_sec(time_surplus));
-				std::this_thread::sleep_for(sleep);
-				// Adjust frame duration to account for time slept.
-				frame_duration += time_surplus;
-			} else {
-				// Still behind but can pay part of the time debt.
-				_time_debt -= time_surplus;
-			}
+	auto game::frame_timings::clear() -> void {
+		frame.clear();
+		update.clear();
+		draw.clear();
+	}
+
+	auto game::record_timings(sec frame_duration, sec update_duration, sec draw_duration) -> void {
+		for (auto timings : {&_run_timings, &_window_timings}) {
+			timings->frame.record(frame_duration);
+			timings->update.record(update_duration);
+			timings->draw.record(draw_duration);
 		}
 
-		// Update FPS buffer.
-		_avg_fps.push(1.0f / frame_duration);
+		auto const now = clock::now();
+		if (to_sec(now - _window_start) < timings_window_duration) { return; }
+
+		auto const format_row = [](std::string_view name, duration_histogram const& histogram) {
+			auto const ms = [](sec duration) { return duration.data * 1000.0f; };
+			return fmt::format("{:<6} p50 {:5.2f}  p95 {:5.2f}  p99 {:5.2f}  max {:5.2f} ms\n",
+				name,
+				ms(histogram.percentile(50)),
+				ms(histogram.percentile(95)),
+				ms(histogram.percentile(99)),
+				ms(histogram.max()));
+		};
+		_timings_text = format_row("frame", _window_timings.frame) + format_row("update", _window_timings.update) +
+			format_row("draw", _window_timings.draw);
+		_window_timings.clear();
+		_window_start = now;
+	}
 
-		return frame_duration;
+	auto game::draw_timings() -> void {
+		sf::Text timings_text{_timings_text, _fonts.firamono, 14};
+		timings_text.setOutlineColor(sf::Color::Black);
+		timings_text.setOutlineThickness(1.0f);
+		timings_text.setFillColor(sf::Color::White);
+		_window.draw(timings_text);
 	}
 
-	auto game::draw_fps() -> void {
-		sf::Text fps_text{fmt::format("{}", _avg_fps.get()), _fonts.firamono, 20};
-		fps_text.setOutlineColor(sf::Color::Black);
-		fps_text.setOutlineThickness(1.0f);
-		fps_text.setFillColor(sf::Color::White);
-		_window.draw(fps_text);
+	auto game::export_timings() const -> void {
+		std::ofstream fout{"frame_timings.csv"};
+		fout << "step,p50_ms,p95_ms,p99_ms,max_ms,count\n";
+		fout << "frame,";
+		_run_timings.frame.write_csv_row(fout);
+		fout << "update,";
+		_run_timings.update.write_csv_row(fout);
+		fout << "draw,";
+		_run_timings.draw.write_csv_row(fout);
 	}
 
 	auto game::request_quit() -> void {
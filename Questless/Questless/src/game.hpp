@@ -3,16 +3,19 @@
 
 #pragma once
 
-#include "bounded/static.hpp"
 #include "quantities/wall_time.hpp"
 #include "reg.hpp"
 #include "rsrc/fonts.hpp"
+#include "session_recording.hpp"
+#include "utility/duration_histogram.hpp"
+#include "utility/frame_pacer.hpp"
 #include "utility/reference.hpp"
-#include "utility/simple_moving_average.hpp"
 
 #include <SFML/Graphics.hpp>
 
+#include <cstdint>
 #include <deque>
+#include <string>
 
 namespace ql {
 	struct widget;
@@ -20,7 +23,9 @@ namespace ql {
 	//! Represents an instance of the game Questless.
 	struct game {
 		//! @param fullscreen Whether to run the game in fullscreen mode.
-		game(bool fullscreen);
+		//! @param world_seed The seed from which the world is generated.
+		//! @param recorder Records the session for replay, if it's being recorded.
+		game(bool fullscreen, std::uint64_t world_seed, uptr<session_recorder> recorder);
 
 		~game();
 
@@ -38,24 +43,44 @@ namespace ql {
 
 		// Timing
 
-		//! The last time the game updated.
-		clock::time_point _last_update_time = clock::now();
+		//! Frame, update, and draw durations over some span of frames.
+		struct frame_timings {
+			duration_histogram frame;
+			duration_histogram update;
+			duration_histogram draw;
 
-		//! Time debt is nonnegative.
-		static constexpr sec min_time_debt = 0.0_s;
-		//! Capped to prevent too much "fast-forwarding".
+			auto clear() -> void;
+		};
+
+		//! Capped to prevent too much "fast-forwarding" after a long frame.
 		static constexpr sec max_time_debt = 1.0_s;
-		//! How far behind the target frame duration the scene is.
-		static_bounded<sec, min_time_debt, max_time_debt> _time_debt = 0.0_s;
 
-		simple_moving_average<per_sec, 25> _avg_fps;
+		//! How long the overlay's timings are collected before they're shown.
+		static constexpr sec timings_window_duration = 1.0_s;
+
+		frame_pacer _pacer{target_frame_duration, max_time_debt};
+
+		//! Timings over the whole run, exported when the game ends.
+		frame_timings _run_timings;
+
+		//! Timings over the current overlay window.
+		frame_timings _window_timings;
+
+		//! When the current overlay window started.
+		clock::time_point _window_start = clock::now();
+
+		//! The overlay text for the last complete window.
+		std::string _timings_text;
+
+		//! Records the durations of the last frame and its update and draw steps, refreshing the overlay text when the
+		//! current window is complete.
+		auto record_timings(sec frame_duration, sec update_duration, sec draw_duration) -> void;
 
-		//! Tries to keep the scene running at the target frame rate.
-		//! @return The duration of the last frame.
-		auto regulate_timing() -> sec;
+		//! Draws the timings overlay.
+		auto draw_timings() -> void;
 
-		//! Draws the FPS counter.
-		auto draw_fps() -> void;
+		//! Writes the timings over the whole run to a CSV file.
+		auto export_timings() const -> void;
 
 		//! Inform the root element that the user is trying to quit.
 		auto request_quit() -> void;
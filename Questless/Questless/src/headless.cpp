@@ -0,0 +1,417 @@
+//! @file
+//! @copyright See <a href="LICENSE.txt">LICENSE.txt</a>.
+
+#include "headless.hpp"
+
+#include "session_recording.hpp"
+#include "simulation.hpp"
+
+#include "agents/agent.hpp"
+#include "agents/command_script.hpp"
+#include "entities/beings/human.hpp"
+#include "entities/beings/world_view.hpp"
+#include "entities/perception.hpp"
+#include "utility/duration_histogram.hpp"
+#include "utility/random.hpp"
+#include "world/field_of_view.hpp"
+#include "world/region.hpp"
+#include "world/spawn_player.hpp"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <array>
+#include <exception>
+#include <functional>
+#include <numeric>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace ql {
+	namespace {
+		//! Adds @p count humans with basic AIs to random free tiles near the center of the region @p region_id.
+		auto populate(reg& reg, id region_id, std::uint64_t world_seed, int count) -> void {
+			auto& region = reg.get<ql::region>(region_id);
+			// Place beings reproducibly for a given seed.
+			keyed_prng prng{combine_keys(world_seed, string_key("headless"))};
+			// Keep to the sections generated around the center, which stay loaded when there are no section anchors.
+			auto const max_offset = (section_radius + section_diameter).data;
+			// Give up eventually if the area is too full.
+			int const max_attempts = 100 * count;
+			int added = 0;
+			for (int attempts = 0; added < count && attempts < max_attempts; ++attempts) {
+				tile_hex_point const coords{
+					pace{prng.uniform(-max_offset, max_offset)}, pace{prng.uniform(-max_offset, max_offset)}};
+				if (region.entity_id_at(coords)) { continue; }
+				id const human_id = reg.create();
+				make_human(reg, human_id, location{region_id, coords}, {basic_ai{reg, human_id}});
+				if (region.try_add(human_id, coords)) {
+					++added;
+				} else {
+					reg.destroy(human_id);
+				}
+			}
+			if (added < count) { fmt::print("Only found room for {} of {} beings.\n", added, count); }
+		}
+
+		//! Prints the tick rate of @p simulation and the time spent in each of its systems, given that it ran for
+		//! @p total_time.
+		auto print_timings(simulation const& simulation, sec total_time) -> void {
+			// Rates and per-tick times are meaningless without any ticks or measurable time.
+			if (simulation.tick_count() == 0 || total_time <= 0.0_s) {
+				fmt::print("Ran {} ticks in {:.3f} s.\n", simulation.tick_count(), total_time.data);
+				return;
+			}
+			auto const& timings = simulation.timings();
+			fmt::print("Ran {} ticks in {:.3f} s ({:.1f} ticks/s).\n",
+				simulation.tick_count(),
+				total_time.data,
+				simulation.tick_count() / total_time.data);
+			auto const print_timing = [&](char const* system, sec time) {
+				fmt::print("  {:<8}{:>10.3f} ms/tick{:>8.1f}%\n",
+					system,
+					1000.0f * time.data / simulation.tick_count(),
+					100.0f * time.data / total_time.data);
+			};
+			print_timing("region", timings.region);
+			print_timing("bodies", timings.bodies);
+			print_timing("turns", timings.turns);
+			print_timing("effects", timings.effects);
+		}
+
+		//! Anchors the sections within @p anchor_radius of the section at the origin of the region @p region_id, and
+		//! updates the region until they're all installed.
+		auto load_sections_around(reg& reg, id region_id, section_span anchor_radius) -> void {
+			auto& region = reg.get<ql::region>(region_id);
+			id const anchor_id = reg.create();
+			reg.assign<location>(anchor_id, location{region_id, tile_hex_point{0_pace, 0_pace}});
+			reg.assign<section_anchor>(anchor_id, section_anchor{anchor_radius});
+			auto const all_loaded = [&] {
+				for (section_span q = -anchor_radius; q <= anchor_radius; ++q) {
+					for (section_span r = -anchor_radius; r <= anchor_radius; ++r) {
+						tile_hex_point const center{q.data * section_diameter, r.data * section_diameter};
+						if (!region.tile_at(center)) { return false; }
+					}
+				}
+				return true;
+			};
+			while (!all_loaded()) {
+				region.update(1_tick);
+			}
+		}
+
+		//! Times perceiving every tile in the rhombus around the player in one batch, as world views do, against
+		//! perceiving each tile separately.
+		auto benchmark_perception(std::uint64_t world_seed) -> void {
+			reg reg;
+			id const region_id = make_region(reg, reg.create(), "Region 1", world_seed);
+			id const viewer_id = create_and_spawn_player(reg, region_id);
+			auto const& region = reg.get<ql::region>(region_id);
+			auto const origin = reg.get<location>(viewer_id).coords;
+			auto const visual_range = perceptor_context{reg, viewer_id}.visual_range;
+
+			std::vector<tile_hex_point> targets;
+			for (pace q = -visual_range; q <= visual_range; ++q) {
+				for (pace r = -visual_range; r <= visual_range; ++r) {
+					targets.push_back(origin + tile_hex_vector{q, r});
+				}
+			}
+			std::vector<perception> scalar_perceptions(targets.size());
+			std::vector<perception> batch_perceptions(targets.size());
+			constexpr int repetitions = 200;
+
+			auto const scalar_start_time = clock::now();
+			for (int i = 0; i < repetitions; ++i) {
+				for (std::size_t j = 0; j < targets.size(); ++j) {
+					scalar_perceptions[j] = perception_of(reg, viewer_id, targets[j]);
+				}
+			}
+			sec const scalar_time = to_sec(clock::now() - scalar_start_time);
+
+			// Include the per-view setup the batch needs, since perception_of pays for its own every call.
+			auto const batch_start_time = clock::now();
+			for (int i = 0; i < repetitions; ++i) {
+				perceptor_context const perceptor{reg, viewer_id};
+				field_of_view const fov{region, origin, perceptor.visual_range};
+				perceptions_of(perceptor, targets, fov, batch_perceptions);
+			}
+			sec const batch_time = to_sec(clock::now() - batch_start_time);
+
+			auto const sample_count = static_cast<double>(repetitions * targets.size());
+			auto const ns_per_target = [&](sec time) { return 1e9 * time.data / sample_count; };
+			fmt::print("Perception of {} tiles within {} paces, {} times:\n",
+				targets.size(),
+				visual_range.data,
+				repetitions);
+			fmt::print("  scalar {:>10.1f} ns/tile\n", ns_per_target(scalar_time));
+			fmt::print("  batch  {:>10.1f} ns/tile ({:.1f}x)\n",
+				ns_per_target(batch_time),
+				scalar_time.data / batch_time.data);
+			// Field of view rays may deviate slightly from the straight lines perception_of traces past occupants.
+			auto const mismatch_count = std::inner_product(scalar_perceptions.begin(),
+				scalar_perceptions.end(),
+				batch_perceptions.begin(),
+				0,
+				std::plus<>{},
+				std::not_equal_to<>{});
+			fmt::print("  {} tiles perceived differently due to occlusion\n", mismatch_count);
+		}
+
+		//! Times radius, view-cone, and nearest-entity queries at random points among @p entity_count entities, against
+		//! a scan of every entity for the same radius queries.
+		auto benchmark_entity_queries(std::uint64_t world_seed, int entity_count) -> void {
+			reg reg;
+			id const region_id = make_region(reg, reg.create(), "Region 1", world_seed);
+			auto& region = reg.get<ql::region>(region_id);
+
+			// Anchor enough sections around the origin to leave about three quarters of their tiles empty.
+			section_span anchor_radius = 1_section_span;
+			auto const section_count = [&] {
+				return static_cast<std::size_t>((2 * anchor_radius.data + 1) * (2 * anchor_radius.data + 1));
+			};
+			while (section_count() * section_tile_count < 4 * static_cast<std::size_t>(entity_count)) {
+				++anchor_radius;
+			}
+			load_sections_around(reg, region_id, anchor_radius);
+
+			// Scatter plain entities over the anchored sections.
+			int const extent = (anchor_radius.data * section_diameter + section_radius).data;
+			keyed_prng prng{combine_keys(world_seed, string_key("entity queries"))};
+			for (int added = 0; added < entity_count;) {
+				tile_hex_point const coords{pace{prng.uniform(-extent, extent)}, pace{prng.uniform(-extent, extent)}};
+				if (region.entity_id_at(coords)) { continue; }
+				id const entity_id = reg.create();
+				reg.assign<location>(entity_id, location{region_id, coords});
+				if (region.try_add(entity_id, coords)) { ++added; }
+			}
+
+			constexpr int query_count = 1000;
+			constexpr auto radius = 10_pace;
+			constexpr std::size_t k = 10;
+			std::vector<tile_hex_point> origins;
+			std::vector<hex_direction> directions;
+			for (int i = 0; i < query_count; ++i) {
+				origins.push_back({pace{prng.uniform(-extent, extent)}, pace{prng.uniform(-extent, extent)}});
+				directions.push_back(static_cast<hex_direction>(prng.uniform(0, 5)));
+			}
+
+			fmt::print("{} queries among {} entities in {} sections:\n", query_count, entity_count, section_count());
+			// Sum the results so that the queries can't be optimized away, and to compare the scan with the index.
+			auto const time_queries = [&](char const* name, auto const& query) {
+				std::size_t result_count = 0;
+				auto const start_time = clock::now();
+				for (int i = 0; i < query_count; ++i) {
+					result_count += query(origins[i], directions[i]);
+				}
+				sec const time = to_sec(clock::now() - start_time);
+				fmt::print(
+					"  {:<8}{:>10.2f} us/query{:>12} results\n", name, 1e6 * time.data / query_count, result_count);
+			};
+			time_queries("within", [&](tile_hex_point origin, hex_direction) {
+				std::size_t count = 0;
+				region.for_each_entity_within(origin, radius, [&](tile_hex_point, id) { ++count; });
+				return count;
+			});
+			time_queries("scan", [&](tile_hex_point origin, hex_direction) {
+				std::size_t count = 0;
+				for (auto const entity_id : reg.view<location>()) {
+					auto const& location = reg.get<ql::location>(entity_id);
+					if (location.region_id == region_id && (location.coords - origin).length() <= radius) { ++count; }
+				}
+				return count;
+			});
+			time_queries("in view", [&](tile_hex_point origin, hex_direction direction) {
+				std::size_t count = 0;
+				region.for_each_entity_in_view(origin, direction, radius, [&](tile_hex_point, id) { ++count; });
+				return count;
+			});
+			time_queries("nearest", [&](tile_hex_point origin, hex_direction) {
+				return region.nearest_entities(origin, k, 4 * radius).size();
+			});
+		}
+
+		//! Times constructing the player's world view at several visual ranges, and walking the tiles in view through a
+		//! section cursor against looking up each tile's section in the region's section directory.
+		auto benchmark_world_view(std::uint64_t world_seed) -> void {
+			reg reg;
+			id const region_id = make_region(reg, reg.create(), "Region 1", world_seed);
+			id const viewer_id = create_and_spawn_player(reg, region_id);
+			auto const& region = reg.get<ql::region>(region_id);
+			auto const origin = reg.get<location>(viewer_id).coords;
+
+			constexpr std::array visual_ranges{10_pace, 30_pace, 60_pace};
+			// Load every section within the largest range of the player.
+			auto const max_extent = (origin - tile_hex_point{0_pace, 0_pace}).length() + visual_ranges.back();
+			load_sections_around(reg, region_id, section_span{max_extent.data / section_diameter.data + 1});
+
+			auto& vision_sources = reg.get<body>(viewer_id).stats.a.vision_sources.cur;
+			if (vision_sources.empty()) { vision_sources.emplace_back(); }
+			auto const base_vision = vision_sources.front();
+
+			constexpr int repetitions = 100;
+			fmt::print("World view construction, {} times per range:\n", repetitions);
+			for (auto const visual_range : visual_ranges) {
+				// Visual range is acuity over the perception lost per pace, ten perception.
+				auto vision = base_vision;
+				vision.acuity = perception{10 * visual_range.data};
+				vision_sources.assign(1, vision);
+
+				std::size_t tile_view_count = 0;
+				auto const view_start_time = clock::now();
+				for (int i = 0; i < repetitions; ++i) {
+					world_view const view{reg, viewer_id};
+					tile_view_count = view.tile_views.size();
+				}
+				sec const view_time = to_sec(clock::now() - view_start_time);
+
+				// The tile walk alone, with and without a cursor. Count the loaded tiles so the walk isn't optimized
+				// away.
+				auto const time_walk = [&](auto const& tile_at) {
+					std::size_t loaded_count = 0;
+					auto const start_time = clock::now();
+					for (int i = 0; i < repetitions; ++i) {
+						for (pace q = -visual_range; q <= visual_range; ++q) {
+							for (pace r = -visual_range; r <= visual_range; ++r) {
+								auto const offset = tile_hex_vector{q, r};
+								if (offset.length() <= visual_range && tile_at(origin + offset)) { ++loaded_count; }
+							}
+						}
+					}
+					return std::pair{to_sec(clock::now() - start_time), loaded_count};
+				};
+				auto const [directory_time, directory_count] =
+					time_walk([&](tile_hex_point coords) { return region.tile_at(coords).has_value(); });
+				auto cursor = region.cursor();
+				auto const [cursor_time, cursor_count] =
+					time_walk([&](tile_hex_point coords) { return cursor.tile_at(coords).has_value(); });
+
+				auto const ns_per_tile = [&](sec time, std::size_t count) {
+					return count == 0 ? 0.0 : 1e9 * time.data / static_cast<double>(count);
+				};
+				fmt::print("  {:>3} paces {:>10.1f} us/view ({} tiles perceived)\n",
+					visual_range.data,
+					1e6 * view_time.data / repetitions,
+					tile_view_count);
+				fmt::print("            tile walk: directory {:>6.1f} ns/tile, cursor {:>6.1f} ns/tile ({:.1f}x)\n",
+					ns_per_tile(directory_time, directory_count),
+					ns_per_tile(cursor_time, cursor_count),
+					directory_time.data / cursor_time.data);
+			}
+		}
+
+		//! Replays the session recorded at @p path.
+		//! @return Whether the replay ended in the same state as the recording.
+		auto replay(std::filesystem::path const& path) -> bool {
+			auto const recording = load_recording(path);
+			fmt::print("Replaying {}: seed {}, {} commands over {} ticks.\n",
+				path.string(),
+				recording.world_seed,
+				recording.commands.size(),
+				recording.end_tick);
+
+			// Set up the world the same way the game does, but with the player taking commands from the recording.
+			reg reg;
+			id const region_id = make_region(reg, reg.create(), "Region 1", recording.world_seed);
+			id const player_id = create_and_spawn_player(reg, region_id);
+			command_script script{recording.commands};
+			std::get<player>(reg.get<agent>(player_id).value).set_script(script);
+
+			simulation simulation{reg, region_id};
+			simulation.seed_prng();
+			duration_histogram tick_times;
+			auto const start_time = clock::now();
+			// The session ended with the player awaiting a command, so run until the player awaits one the recording
+			// doesn't have. If the replay diverges, that may happen early or not at all.
+			for (;;) {
+				script.set_tick(simulation.tick_count());
+				auto const tick_start_time = clock::now();
+				bool const completed = simulation.tick();
+				tick_times.record(to_sec(clock::now() - tick_start_time));
+				if (!completed || simulation.tick_count() > recording.end_tick) { break; }
+			}
+			sec const total_time = to_sec(clock::now() - start_time);
+
+			print_timings(simulation, total_time);
+			auto const ms = [](sec duration) { return duration.data * 1000.0f; };
+			fmt::print("  tick time p50 {:.3f} ms, p95 {:.3f} ms, p99 {:.3f} ms, max {:.3f} ms\n",
+				ms(tick_times.percentile(50)),
+				ms(tick_times.percentile(95)),
+				ms(tick_times.percentile(99)),
+				ms(tick_times.max()));
+
+			auto const end_state_hash = state_hash(reg, region_id);
+			fmt::print("  final state hash {:016x}\n", end_state_hash);
+			if (!script.done()) {
+				fmt::print("  DIVERGED: the player awaited a command in tick {}, but the next is from tick {}.\n",
+					simulation.tick_count(),
+					script.next_tick());
+				return false;
+			}
+			if (simulation.tick_count() != recording.end_tick || end_state_hash != recording.end_state_hash) {
+				fmt::print("  DIVERGED: the recording ended during tick {} with state hash {:016x}.\n",
+					recording.end_tick,
+					recording.end_state_hash);
+				return false;
+			}
+			fmt::print("  Matched the recording.\n");
+			return true;
+		}
+
+		//! Replays the session recorded at @p path, reporting any error instead of throwing it.
+		//! @return Whether the replay ended in the same state as the recording.
+		auto try_replay(std::filesystem::path const& path) -> bool {
+			try {
+				return replay(path);
+			} catch (std::exception const& e) {
+				fmt::print("FAILED to replay {}: {}\n", path.string(), e.what());
+				return false;
+			}
+		}
+	}
+
+	auto run_headless(std::uint64_t world_seed, int tick_count, int extra_being_count) -> void {
+		reg reg;
+		id const region_id = make_region(reg, reg.create(), "Region 1", world_seed);
+		populate(reg, region_id, world_seed, extra_being_count);
+
+		simulation simulation{reg, region_id};
+		simulation.seed_prng();
+		auto const start_time = clock::now();
+		for (int i = 0; i < tick_count; ++i) {
+			// No agent in a headless run awaits input, so every tick completes.
+			simulation.tick();
+		}
+		print_timings(simulation, to_sec(clock::now() - start_time));
+	}
+
+	auto replay_headless(std::filesystem::path const& path) -> bool {
+		if (!std::filesystem::is_directory(path)) { return try_replay(path); }
+
+		// Replay a directory's recordings in a consistent order, and keep going past any that fail.
+		std::vector<std::filesystem::path> paths;
+		for (auto const& entry : std::filesystem::directory_iterator{path}) {
+			if (entry.is_regular_file()) { paths.push_back(entry.path()); }
+		}
+		std::sort(paths.begin(), paths.end());
+		int failed_count = 0;
+		for (auto const& recording_path : paths) {
+			if (!try_replay(recording_path)) { ++failed_count; }
+		}
+		fmt::print("{} of {} replays diverged or failed.\n", failed_count, paths.size());
+		return failed_count == 0;
+	}
+
+	auto run_benchmark(std::uint64_t world_seed, std::string_view name, int entity_count) -> bool {
+		if (name == "perception") {
+			benchmark_perception(world_seed);
+		} else if (name == "entity_queries") {
+			benchmark_entity_queries(world_seed, entity_count);
+		} else if (name == "world_view") {
+			benchmark_world_view(world_seed);
+		} else {
+			return false;
+		}
+		return true;
+	}
+}
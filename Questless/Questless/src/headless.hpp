@@ -0,0 +1,37 @@
+//! @file
+//! @copyright See <a href="LICENSE.txt">LICENSE.txt</a>.
+//!
+//! Headless mode doesn't open a window, but it still runs inside the Questless executable, which is built only by the
+//! MSVC project and links SFML. The simulation code itself also still depends on SFML headers (e.g. sf::Uint8 in
+//! utility/utility.hpp). So headless runs, replays, and benchmarks can't yet be built for a machine without SFML or
+//! run in CI on Linux; that needs the simulation split into its own library with no SFML dependency.
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
+
+namespace ql {
+	//! Generates a region from @p world_seed, adds @p extra_being_count AI-controlled humans to it, and runs its game
+	//! logic for @p tick_count ticks as fast as possible. No window is created and no audio or textures are loaded.
+	//! Prints the tick rate and the time spent in each system.
+	auto run_headless(std::uint64_t world_seed, int tick_count, int extra_being_count) -> void;
+
+	//! Replays the session recorded at @p path, or each session recorded in it if it's a directory, as fast as
+	//! possible and without a window. Prints the tick rate, tick time percentiles, and the time spent in each system,
+	//! and whether each replay ended in the same state as its recording. Files that can't be loaded as recordings are
+	//! reported and count as failed replays.
+	//! @return Whether every replay ended in the same state as its recording.
+	auto replay_headless(std::filesystem::path const& path) -> bool;
+
+	//! Runs the benchmark named @p name in a region generated from @p world_seed, without a window, and prints its
+	//! timings. The benchmarks are:
+	//! - perception: perceiving every tile around a being in one batch versus one tile at a time.
+	//! - entity_queries: radius, view-cone, and nearest-entity queries among @p entity_count entities versus scanning
+	//!   every entity.
+	//! - world_view: constructing the player's world view at visual ranges of 10, 30, and 60 paces, and walking the
+	//!   tiles in view with a section cursor versus looking up each tile's section.
+	//! @return Whether @p name names a benchmark.
+	auto run_benchmark(std::uint64_t world_seed, std::string_view name, int entity_count) -> bool;
+}
@@ -5,6 +5,7 @@
 
 #include "equipment.hpp"
 
+#include "agents/actions.hpp"
 #include "agents/agent.hpp"
 #include "entities/beings/being.hpp"
 
@@ -25,35 +26,40 @@ namespace ql {
 	auto equipment::equip(ql::id actor_id) -> void {
 		//! @todo Allow bearer to choose where to equip item.
 
+		// Set the bearer first so that a forced unequip can find the parts already slotted into.
+		o_bearer_id = actor_id;
+		auto& bearer_body = reg->get<ql::body>(actor_id);
 		for (auto& tab : tabs) {
 			bool found = false;
-			reg->get<ql::body>(actor_id).for_all_parts([&](body_part& part) {
-				if (!found && part.tags.find(tab.tag) != part.tags.end() && !part.equipped_item_id) {
+			bearer_body.for_all_parts([&](body_part& part) {
+				if (!found && part.tags.contains(tab.tag) && !part.equipped_item_id) {
 					part.equipped_item_id = id;
-					tab.o_part_id = part.id;
+					tab.o_part_idx = part.idx;
 					found = true;
 				}
 			});
-			if (!found) { forced_unequip(); }
+			if (!found) {
+				forced_unequip();
+				return;
+			}
 		}
-		o_bearer_id = actor_id;
-		//! @todo Incur equip cost.
+		bearer_body.invalidate_stats();
+		spend(*reg, actor_id, equip_cost);
 	}
 
 	auto equipment::unequip() -> void {
 		if (!equipped()) return;
-		//! @todo Incur unequip cost.
+		spend(*reg, *o_bearer_id, unequip_cost);
 		forced_unequip();
 	}
 
 	auto equipment::forced_unequip() -> void {
+		auto const bearer_body = o_bearer_id && reg->valid(*o_bearer_id) ? reg->try_get<body>(*o_bearer_id) : nullptr;
 		for (auto& tab : tabs) {
-			if (tab.o_part_id && reg->valid(*tab.o_part_id)) {
-				auto& part = reg->get<body_part>(*tab.o_part_id);
-				part.equipped_item_id = std::nullopt;
-			}
-			tab.o_part_id = std::nullopt;
+			if (tab.o_part_idx && bearer_body) { bearer_body->parts[*tab.o_part_idx].equipped_item_id = std::nullopt; }
+			tab.o_part_idx = std::nullopt;
 		}
+		if (bearer_body) { bearer_body->invalidate_stats(); }
 		o_bearer_id = std::nullopt;
 	}
 }
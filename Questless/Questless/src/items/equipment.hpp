@@ -18,8 +18,8 @@ namespace ql {
 		struct tab {
 			//! The type of part this tab can slot into.
 			body_part::tag tag;
-			//! The body part this tab is slotted into or nullopt if none.
-			std::optional<id> o_part_id;
+			//! The index in the bearer's body of the part this tab is slotted into or nullopt if none.
+			std::optional<std::size_t> o_part_idx;
 		};
 
 		reg_ptr reg;
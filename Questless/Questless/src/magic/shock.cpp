@@ -30,7 +30,7 @@ namespace ql::magic {
 
 		//! Add a lightning bolt effect.
 		auto& region = reg.get<ql::region>(caster_location.region_id);
-		region.add_effect({effects::lightning_bolt{target}});
+		region.add_effect(caster_id, {effects::lightning_bolt{target}});
 
 		if (auto target_entity_id = region.entity_id_at(target)) {
 			//! @todo What about damaging objects?
@@ -39,20 +39,21 @@ namespace ql::magic {
 
 				// Pick a random strike path from the root to a leaf part and deal progressively lower damage to each part.
 				dmg::group group = {cancel::quantity_cast<dmg::shock>(quality * damage)};
-				body_part* part = &reg.get<body_part>(target_body->root_part_id);
+				body_part* part = &target_body->root_part();
 				for (;;) {
 					// Deal damage to the current part.
 					part->take_damage(group, caster_id);
 					// Reduce the damage by half.
 					group /= 2;
 					// Stop if there are no attachments.
-					if (part->attachments.empty()) { break; }
+					auto const attachments = target_body->attachments_of(*part);
+					if (attachments.empty()) { break; }
 					// Pick a random attachment.
-					auto& attachment = part->attachments[uniform(std::size_t{0}, part->attachments.size() - 1)];
+					auto const& attachment = attachments[uniform(std::size_t{0}, attachments.size() - 1)];
 					// Stop if the attachment has no attached part.
-					if (!attachment.o_part_id) { break; }
+					if (!attachment.o_part_idx) { break; }
 					// Descend the tree.
-					part = &reg.get<body_part>(*attachment.o_part_id);
+					part = &target_body->parts[*attachment.o_part_idx];
 				}
 			}
 		}
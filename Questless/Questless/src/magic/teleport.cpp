@@ -23,8 +23,8 @@ namespace ql::magic {
 
 		// Add lightning bolt effects to region.
 		auto& region = reg.get<ql::region>(caster_location.region_id);
-		region.add_effect({effects::lightning_bolt{caster_location.coords}});
-		region.add_effect({effects::lightning_bolt{target}});
+		region.add_effect(caster_id, {effects::lightning_bolt{caster_location.coords}});
+		region.add_effect(caster_id, {effects::lightning_bolt{target}});
 
 		if (!region.try_move(caster_id, target)) {
 			//! @todo Try to move to the nearest free location.
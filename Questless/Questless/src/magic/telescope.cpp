@@ -26,6 +26,6 @@ namespace ql::magic {
 		// Add telescope effect to region.
 		auto const caster_location = reg.get<location>(caster_id);
 		auto& region = reg.get<ql::region>(caster_location.region_id);
-		region.add_effect({effects::telescope{caster_location.coords, caster_id}});
+		region.add_effect(caster_id, {effects::telescope{caster_location.coords, caster_id}});
 	}
 }
@@ -5,6 +5,80 @@
 #include "doctest_wrapper/impl.hpp"
 
 #include "game.hpp"
+#include "headless.hpp"
+#include "session_recording.hpp"
+
+#include <fmt/format.h>
+
+#include <charconv>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <string_view>
+#include <system_error>
+
+namespace {
+	//! The value of a "--<name>=<value>" command-line argument, or nullopt if there is none.
+	auto get_option(int argc, char* argv[], std::string_view name) -> std::optional<std::string_view> {
+		auto const prefix = fmt::format("--{}=", name);
+		for (int i = 1; i < argc; ++i) {
+			std::string_view const arg = argv[i];
+			if (arg.starts_with(prefix)) { return arg.substr(prefix.size()); }
+		}
+		return std::nullopt;
+	}
+
+	//! A malformed command-line argument.
+	struct usage_error : std::runtime_error {
+		using std::runtime_error::runtime_error;
+	};
+
+	//! The value of a "--<name>=<n>" command-line argument, or nullopt if there is none.
+	//! @throw usage_error if n is not a positive integer.
+	auto get_count_option(int argc, char* argv[], std::string_view name) -> std::optional<int> {
+		auto const o_value = get_option(argc, argv, name);
+		if (!o_value) { return std::nullopt; }
+		int count = 0;
+		auto const end = o_value->data() + o_value->size();
+		auto const [ptr, error] = std::from_chars(o_value->data(), end, count);
+		if (error != std::errc{} || ptr != end || count <= 0) {
+			throw usage_error{fmt::format("--{} must be a positive integer, not \"{}\".", name, *o_value)};
+		}
+		return count;
+	}
+
+	//! Prints the command-line usage, after @p error.
+	auto print_usage(std::string_view error) -> void {
+		fmt::print(stderr,
+			"{}\n"
+			"Usage: Questless [--seed=<n>] [--record=<path> | --replay=<path> | --headless=<ticks> [--beings=<n>] |\n"
+			"                 --benchmark=<name> [--beings=<n>]]\n",
+			error);
+	}
+
+	//! The world seed given by a "--seed=<n>" command-line argument, or nullopt if there is none.
+	//! @throw usage_error if n is not an unsigned 64-bit integer.
+	auto get_seed_option(int argc, char* argv[]) -> std::optional<std::uint64_t> {
+		auto const o_value = get_option(argc, argv, "seed");
+		if (!o_value) { return std::nullopt; }
+		std::uint64_t seed = 0;
+		auto const end = o_value->data() + o_value->size();
+		auto const [ptr, error] = std::from_chars(o_value->data(), end, seed);
+		if (error != std::errc{} || ptr != end) {
+			throw usage_error{fmt::format("--seed must be an integer from 0 to {}, not \"{}\".", UINT64_MAX, *o_value)};
+		}
+		return seed;
+	}
+
+	//! A random world seed.
+	auto random_world_seed() -> std::uint64_t {
+		std::random_device rng{};
+		return (static_cast<std::uint64_t>(rng()) << 32) | rng();
+	}
+}
 
 auto main(int argc, char* argv[]) -> int {
 	int result = 0;
@@ -15,13 +89,55 @@ auto main(int argc, char* argv[]) -> int {
 	context.setOption("success", false);
 	context.applyCommandLine(argc, argv);
 	result = context.run();
-#else
-	// Command-line arguments unused in release build. Supress unused variable warnings.
-	(void)argc;
-	(void)argv;
 #endif
 
-	ql::game{false}.run();
+	// Reject malformed arguments up front, before spending any time on setup.
+	std::optional<std::uint64_t> o_world_seed;
+	std::optional<int> o_tick_count;
+	std::optional<int> o_being_count;
+	try {
+		o_world_seed = get_seed_option(argc, argv);
+		o_tick_count = get_count_option(argc, argv, "headless");
+		o_being_count = get_count_option(argc, argv, "beings");
+	} catch (usage_error const& e) {
+		print_usage(e.what());
+		return 1;
+	}
+
+	if (auto const o_replay_path = get_option(argc, argv, "replay")) {
+		// Replay a recorded session, or a directory of them, e.g. "--replay=sessions". Fails if any replay diverges.
+		if (!ql::replay_headless(std::filesystem::path{*o_replay_path})) { result = 1; }
+		return result;
+	}
+
+	// Report the seed so that the world can be reproduced.
+	auto const world_seed = o_world_seed ? *o_world_seed : random_world_seed();
+	fmt::print("World seed: {}\n", world_seed);
+
+	if (auto const o_benchmark = get_option(argc, argv, "benchmark")) {
+		// Run a benchmark without a window, e.g. "--benchmark=perception" or
+		// "--benchmark=entity_queries --beings=100000".
+		if (!ql::run_benchmark(world_seed, *o_benchmark, o_being_count.value_or(10'000))) {
+			fmt::print("Unknown benchmark \"{}\". Benchmarks: perception, entity_queries, world_view.\n", *o_benchmark);
+			result = 1;
+		}
+	} else if (o_tick_count) {
+		// Run the simulation alone, without a window, e.g. "--headless=1000 --beings=500".
+		ql::run_headless(world_seed, *o_tick_count, o_being_count.value_or(0));
+	} else {
+		// Optionally record the session for replay, e.g. "--record=sessions/fight.qrec". Open the recording now so
+		// that a bad path is reported before the session is played.
+		ql::uptr<ql::session_recorder> recorder;
+		if (auto const o_record = get_option(argc, argv, "record")) {
+			try {
+				recorder = ql::umake<ql::session_recorder>(std::filesystem::path{*o_record}, world_seed);
+			} catch (std::exception const& e) {
+				fmt::print(stderr, "Can't record the session: {}\n", e.what());
+				return 1;
+			}
+		}
+		ql::game{false, world_seed, std::move(recorder)}.run();
+	}
 
 	return result;
 }
@@ -0,0 +1,312 @@
+//! @file
+//! @copyright See <a href="LICENSE.txt">LICENSE.txt</a>.
+
+#include "session_recording.hpp"
+
+#include "entities/beings/body.hpp"
+#include "items/inventory.hpp"
+#include "utility/random.hpp"
+#include "world/region.hpp"
+
+#include <cereal/archives/binary.hpp>
+#include <cereal/types/variant.hpp>
+#include <cereal/types/vector.hpp>
+#include <fmt/format.h>
+
+#include <bit>
+#include <exception>
+#include <stdexcept>
+#include <type_traits>
+
+namespace ql {
+	namespace {
+		//! Begins every recording, so that other files are rejected before they're misread. Reads "QREC" in a hex dump.
+		constexpr std::uint32_t recording_magic = 0x43455251;
+
+		//! Follows the magic number. Increment whenever the format of @p session_recording changes.
+		constexpr std::uint32_t recording_version = 1;
+
+		auto write_recording(session_recording const& recording, std::ostream& out) -> void {
+			{ // The archive may not write everything until it's destroyed.
+				cereal::BinaryOutputArchive archive{out};
+				archive(recording_magic, recording_version, recording);
+			}
+			out.flush();
+			if (!out) { throw std::runtime_error{"The recording couldn't be written."}; }
+		}
+	}
+
+	auto save_recording(session_recording const& recording, std::filesystem::path const& path) -> void {
+		std::ofstream fout{path, std::ios::binary};
+		if (!fout) { throw std::runtime_error{fmt::format("Couldn't open \"{}\" for writing.", path.string())}; }
+		write_recording(recording, fout);
+	}
+
+	auto load_recording(std::filesystem::path const& path) -> session_recording {
+		std::ifstream fin{path, std::ios::binary};
+		if (!fin) { throw std::runtime_error{fmt::format("Couldn't open \"{}\".", path.string())}; }
+		// Cereal throws cereal::Exception, a std::runtime_error, if the file ends early.
+		cereal::BinaryInputArchive archive{fin};
+		std::uint32_t magic = 0;
+		std::uint32_t version = 0;
+		archive(magic, version);
+		if (magic != recording_magic) {
+			throw std::runtime_error{fmt::format("\"{}\" isn't a session recording.", path.string())};
+		}
+		if (version != recording_version) {
+			throw std::runtime_error{fmt::format("\"{}\" is a version {} recording, but only version {} is supported.",
+				path.string(),
+				version,
+				recording_version)};
+		}
+		session_recording result;
+		archive(result);
+		return result;
+	}
+
+	auto state_hash(reg& reg, id region_id) -> std::uint64_t {
+		auto& region = reg.get<ql::region>(region_id);
+		std::uint64_t result = combine_keys(0, static_cast<std::uint64_t>(region.time().data));
+		auto const add = [&result](auto value) {
+			if constexpr (std::is_floating_point_v<decltype(value)>) {
+				result = combine_keys(result, std::bit_cast<std::uint32_t>(static_cast<float>(value)));
+			} else {
+				result = combine_keys(result, static_cast<std::uint64_t>(value));
+			}
+		};
+		// Inventories and sections are unordered, so items are hashed separately and summed.
+		auto const item_hash = [](std::uint64_t key, id item_id) {
+			return combine_keys(key, static_cast<std::uint64_t>(item_id));
+		};
+
+		// Entities are visited in the order their components were assigned, which is the same for the same session.
+		for (auto const being_id : reg.view<body, location>()) {
+			auto const& location = reg.get<ql::location>(being_id);
+			if (location.region_id != region_id) { continue; }
+			add(being_id);
+			add(location.coords.q.data);
+			add(location.coords.r.data);
+
+			auto const& body = reg.get<ql::body>(being_id);
+			auto const& cond = body.cond;
+			add(cond.energy.get().data);
+			add(cond.satiety.get().data);
+			add(cond.alertness.get().data);
+			add(cond.joy.get().data);
+			add(cond.courage.get().data);
+			add(cond.busy_time.data);
+			add(cond.blood.data);
+			add(static_cast<int>(cond.mortality));
+			add(static_cast<int>(cond.direction));
+
+			for (auto const& part : body.parts) {
+				add(part.stats.a.vitality.cur.data);
+				add(part.status_set.wounds.size());
+				add(part.equipped_item_id ? static_cast<std::uint64_t>(*part.equipped_item_id) + 1 : 0);
+			}
+
+			if (auto const inv = reg.try_get<inventory>(being_id)) {
+				std::uint64_t items_hash = 0;
+				for (auto const item_id : inv->item_ids) {
+					items_hash += item_hash(being_id, item_id);
+				}
+				add(items_hash);
+			}
+		}
+
+		std::uint64_t ground_items_hash = 0;
+		region.for_each_ground_item([&](tile_hex_point coords, id item_id) {
+			auto const coords_key = combine_keys(
+				static_cast<std::uint64_t>(coords.q.data), static_cast<std::uint64_t>(coords.r.data));
+			ground_items_hash += item_hash(coords_key, item_id);
+		});
+		add(ground_items_hash);
+
+		return result;
+	}
+
+	session_recorder::session_recorder(std::filesystem::path path, std::uint64_t world_seed)
+		: _path{std::move(path)}
+		, _recording{world_seed, {}, 0, 0} //
+	{
+		if (_path.has_parent_path()) { std::filesystem::create_directories(_path.parent_path()); }
+		_fout.open(_path, std::ios::binary);
+		if (!_fout) {
+			throw std::runtime_error{fmt::format("Couldn't open \"{}\" to record the session.", _path.string())};
+		}
+	}
+
+	session_recorder::~session_recorder() {
+		// Commands after the last checkpoint were performed but the session didn't get to a state that can be checked.
+		_recording.commands.resize(_checkpoint_command_count);
+		// Throwing from a destructor would terminate the game, so report the failure instead.
+		try {
+			write_recording(_recording, _fout);
+		} catch (std::exception const& e) {
+			fmt::print(stderr, "Couldn't save the session recording to \"{}\": {}\n", _path.string(), e.what());
+		}
+	}
+
+	auto session_recorder::checkpoint(reg& reg, id region_id, std::uint64_t tick) -> void {
+		_checkpoint_command_count = _recording.commands.size();
+		_recording.end_tick = tick;
+		_recording.end_state_hash = state_hash(reg, region_id);
+	}
+
+	auto session_recorder::record(std::uint64_t tick, player_command const& command) -> void {
+		_recording.commands.push_back({tick, command});
+	}
+}
+
+#include "doctest_wrapper/test.hpp"
+
+#include "simulation.hpp"
+
+#include "agents/agent.hpp"
+#include "entities/beings/human.hpp"
+#include "world/spawn_player.hpp"
+
+#include <optional>
+#include <thread>
+
+namespace {
+	//! The state of a fight when the player awaited a command beyond its script.
+	struct fight_outcome {
+		std::uint64_t tick = 0;
+		std::uint64_t state_hash = 0;
+		//! Whether the player performed every command in its script.
+		bool script_done = false;
+		//! Whether the player had an opponent.
+		bool opponent_placed = false;
+	};
+
+	//! Plays a fight in a world generated from @p world_seed between the player and a human next to it, with the player
+	//! performing @p commands, until the player awaits a command beyond them. The two trade blows every few ticks, so
+	//! both perceive injuries and the human retaliates. Call from the thread that should run the simulation.
+	auto play_fight(std::uint64_t world_seed, std::vector<ql::recorded_command> const& commands) -> fight_outcome {
+		using namespace ql;
+
+		reg reg;
+		id const region_id = make_region(reg, reg.create(), "Region 1", world_seed);
+		auto& region = reg.get<ql::region>(region_id);
+		id const player_id = create_and_spawn_player(reg, region_id);
+		command_script script{commands};
+		std::get<player>(reg.get<agent>(player_id).value).set_script(script);
+
+		fight_outcome result;
+
+		// Put the opponent on the first free tile next to the player.
+		auto const player_coords = reg.get<location>(player_id).coords;
+		std::optional<tile_hex_point> o_opponent_coords;
+		for (int direction = 0; direction < 6 && !o_opponent_coords; ++direction) {
+			auto const coords = player_coords.neighbor(static_cast<hex_direction>(direction));
+			if (!region.entity_id_at(coords)) { o_opponent_coords = coords; }
+		}
+		if (!o_opponent_coords) { return result; }
+		id const opponent_id = reg.create();
+		make_human(reg, opponent_id, location{region_id, *o_opponent_coords}, {basic_ai{reg, opponent_id}});
+		result.opponent_placed = region.try_add(opponent_id, *o_opponent_coords);
+		if (!result.opponent_placed) { return result; }
+
+		simulation simulation{reg, region_id};
+		simulation.seed_prng();
+		constexpr int max_tick_count = 1'000;
+		for (int i = 0; i < max_tick_count; ++i) {
+			if (simulation.tick_count() % 3 == 0) {
+				// Trade blows.
+				dmg::group player_blow{2_bludgeon};
+				reg.get<body>(opponent_id).parts.front().take_damage(player_blow, player_id);
+				dmg::group opponent_blow{1_slash};
+				reg.get<body>(player_id).parts.front().take_damage(opponent_blow, opponent_id);
+			}
+			script.set_tick(simulation.tick_count());
+			if (!simulation.tick()) { break; }
+		}
+
+		result.tick = simulation.tick_count();
+		result.state_hash = state_hash(reg, region_id);
+		result.script_done = script.done();
+		return result;
+	}
+}
+
+TEST_CASE("[session_recording] replays match recordings across a fight") {
+	using namespace ql;
+
+	constexpr std::uint64_t world_seed = 42;
+	constexpr std::uint64_t fight_length = 30;
+
+	// Find the player's first turn, then pass every turn from there. Passing takes a tick, so the player's turns are
+	// consecutive.
+	auto const first_turn = play_fight(world_seed, {});
+	REQUIRE(first_turn.opponent_placed);
+	std::vector<recorded_command> passes;
+	for (std::uint64_t tick = first_turn.tick; tick < first_turn.tick + fight_length; ++tick) {
+		passes.push_back({tick, commands::pass{}});
+	}
+
+	// Record the fight on its own thread, as the HUD's game logic thread would.
+	fight_outcome recorded;
+	std::thread{[&] { recorded = play_fight(world_seed, passes); }}.join();
+	REQUIRE(recorded.script_done);
+	CHECK_EQ(recorded.tick, first_turn.tick + fight_length);
+
+	auto const path = std::filesystem::temp_directory_path() / "questless-fight-replay-test.rec";
+	save_recording({world_seed, passes, recorded.tick, recorded.state_hash}, path);
+	auto const recording = load_recording(path);
+	std::filesystem::remove(path);
+
+	auto const replayed = play_fight(recording.world_seed, recording.commands);
+	CHECK(replayed.script_done);
+	CHECK_EQ(replayed.tick, recording.end_tick);
+	CHECK_EQ(replayed.state_hash, recording.end_state_hash);
+}
+
+TEST_CASE("[session_recording] state hashes reflect injuries and items") {
+	using namespace ql;
+
+	reg reg;
+	id const region_id = make_region(reg, reg.create(), "Region 1", 42);
+	id const player_id = create_and_spawn_player(reg, region_id);
+	auto const initial_hash = state_hash(reg, region_id);
+	CHECK_EQ(state_hash(reg, region_id), initial_hash);
+
+	dmg::group blow{1_slash};
+	reg.get<body>(player_id).parts.back().take_damage(blow, std::nullopt);
+	auto const injured_hash = state_hash(reg, region_id);
+	CHECK_NE(injured_hash, initial_hash);
+
+	id const item_id = reg.create();
+	reg.get<inventory>(player_id).add(item_id);
+	CHECK_NE(state_hash(reg, region_id), injured_hash);
+}
+
+TEST_CASE("[session_recording] loading rejects files that aren't recordings") {
+	using namespace ql;
+
+	auto const path = std::filesystem::temp_directory_path() / "questless-not-a-recording.rec";
+	SUBCASE("empty") {
+		std::ofstream{path, std::ios::binary};
+		CHECK_THROWS_AS(load_recording(path), std::runtime_error);
+	}
+	SUBCASE("text") {
+		std::ofstream{path, std::ios::binary} << "Not a recording, but long enough to hold a header.";
+		CHECK_THROWS_AS(load_recording(path), std::runtime_error);
+	}
+	SUBCASE("missing") {
+		std::filesystem::remove(path);
+		CHECK_THROWS_AS(load_recording(path), std::runtime_error);
+	}
+	std::filesystem::remove(path);
+}
+
+TEST_CASE("[session_recording] recorders create the recording's directory") {
+	using namespace ql;
+
+	auto const dir = std::filesystem::temp_directory_path() / "questless-recorder-test";
+	std::filesystem::remove_all(dir);
+	auto const path = dir / "sessions" / "session.rec";
+	{ session_recorder recorder{path, 42}; }
+	CHECK_EQ(load_recording(path).world_seed, 42u);
+	std::filesystem::remove_all(dir);
+}
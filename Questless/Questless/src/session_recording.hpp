@@ -0,0 +1,82 @@
+//! @file
+//! @copyright See <a href="LICENSE.txt">LICENSE.txt</a>.
+
+#pragma once
+
+#include "agents/command_script.hpp"
+#include "reg.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace ql {
+	//! Everything needed to replay a played session, plus the state it ended in to check the replay against.
+	struct session_recording {
+		//! The seed from which the world was generated.
+		std::uint64_t world_seed;
+
+		//! The player's commands, in the order they were performed.
+		std::vector<recorded_command> commands;
+
+		//! The tick during which the session ended, with the player awaiting another command.
+		std::uint64_t end_tick;
+
+		//! The @p state_hash of the region when the session ended.
+		std::uint64_t end_state_hash;
+
+		template <typename Archive>
+		auto serialize(Archive& archive) -> void {
+			archive(world_seed, commands, end_tick, end_state_hash);
+		}
+	};
+
+	//! Writes @p recording to the file at @p path.
+	//! @throw std::runtime_error if the file can't be written.
+	auto save_recording(session_recording const& recording, std::filesystem::path const& path) -> void;
+
+	//! Reads a recording from the file at @p path.
+	//! @throw std::runtime_error if the file can't be read or isn't a recording in the current format.
+	auto load_recording(std::filesystem::path const& path) -> session_recording;
+
+	//! A hash of the state of the region @p region_id and the beings and items in it, for checking that two runs of the
+	//! same session agree. Covers where each being is, its conditions, each part's vitality, wounds, and equipment, its
+	//! inventory, and the items on the ground. Two runs that diverge will almost certainly differ in it soon after.
+	auto state_hash(reg& reg, id region_id) -> std::uint64_t;
+
+	//! Records a session as it's played, and saves the recording when destroyed.
+	struct session_recorder {
+		//! Opens the file at @p path to save the recording to, creating its directory if necessary, so that a bad path
+		//! is caught before the session is played rather than when it ends.
+		//! @param path Where to save the recording.
+		//! @param world_seed The seed from which the session's world was generated.
+		//! @throw std::runtime_error if the file can't be opened for writing.
+		session_recorder(std::filesystem::path path, std::uint64_t world_seed);
+
+		//! Saves the recording, up to the last checkpoint. Reports failure to save on stderr rather than throwing.
+		~session_recorder();
+
+		session_recorder(session_recorder const&) = delete;
+		auto operator=(session_recorder const&) -> session_recorder& = delete;
+
+		//! Marks the current state of the region @p region_id as a point a replay can be checked against. Call each
+		//! time the player is about to take a command, before recording it.
+		//! @param tick The tick being simulated.
+		auto checkpoint(reg& reg, id region_id, std::uint64_t tick) -> void;
+
+		//! Records that the player performed @p command during @p tick.
+		auto record(std::uint64_t tick, player_command const& command) -> void;
+
+	private:
+		std::filesystem::path _path;
+
+		//! The open file the recording is saved to.
+		std::ofstream _fout;
+
+		session_recording _recording;
+
+		//! The number of commands recorded at the last checkpoint.
+		std::size_t _checkpoint_command_count = 0;
+	};
+}
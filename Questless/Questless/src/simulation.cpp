@@ -0,0 +1,84 @@
+//! @file
+//! @copyright See <a href="LICENSE.txt">LICENSE.txt</a>.
+
+#include "simulation.hpp"
+
+#include "agents/agent.hpp"
+#include "entities/beings/body.hpp"
+#include "utility/random.hpp"
+#include "world/region.hpp"
+
+#include <algorithm>
+
+namespace ql {
+	simulation::simulation(reg& reg, id region_id) : _reg{&reg}, _region_id{region_id} {}
+
+	auto simulation::seed_prng() const -> void {
+		ql::seed_prng(combine_keys(_reg->get<region>(_region_id).key(), string_key("simulation")));
+	}
+
+	auto simulation::tick() -> bool {
+		auto& region = _reg->get<ql::region>(_region_id);
+
+		if (_o_suspended_turn) {
+			// The turn may still be awaiting something. Deliver the effects of whatever it's done in the meantime.
+			if (!_o_suspended_turn->done()) {
+				deliver_effects(region);
+				return false;
+			}
+			auto const start_time = clock::now();
+			_o_suspended_turn->rethrow_if_failed();
+			_o_suspended_turn.reset();
+			end_turn(region, _ready_being_ids[_turn_idx++]);
+			_timings.turns += to_sec(clock::now() - start_time);
+		} else {
+			// Advance the region by a tick.
+			auto const region_start_time = clock::now();
+			region.update(1_tick);
+			_timings.region += to_sec(clock::now() - region_start_time);
+
+			// Wake only the beings whose turns have come.
+			auto const bodies_start_time = clock::now();
+			_ready_being_ids = region.pop_ready_beings();
+			_turn_idx = 0;
+			_timings.bodies += to_sec(clock::now() - bodies_start_time);
+		}
+
+		auto const turns_start_time = clock::now();
+		for (; _turn_idx < _ready_being_ids.size(); ++_turn_idx) {
+			auto const being_id = _ready_being_ids[_turn_idx];
+			// An earlier turn this tick may have destroyed this being or put it to sleep.
+			if (!_reg->valid(being_id) || _reg->has<dormant>(being_id)) { continue; }
+
+			// Let the being act. AI turns complete immediately, but the player's turn suspends until the player
+			// passes, and the rest of this tick's turns wait for it.
+			_reg->get<body>(being_id).cond.busy_time = 0_tick;
+			auto turn = _reg->get<agent>(being_id).act();
+			turn.start();
+			if (!turn.done()) {
+				_o_suspended_turn = std::move(turn);
+				_timings.turns += to_sec(clock::now() - turns_start_time);
+				// Let the waiting being perceive what's happened so far.
+				deliver_effects(region);
+				return false;
+			}
+			end_turn(region, being_id);
+		}
+		_timings.turns += to_sec(clock::now() - turns_start_time);
+
+		deliver_effects(region);
+
+		++_tick_count;
+		return true;
+	}
+
+	auto simulation::deliver_effects(region& region) -> void {
+		auto const start_time = clock::now();
+		region.deliver_effects();
+		_timings.effects += to_sec(clock::now() - start_time);
+	}
+
+	auto simulation::end_turn(region& region, id being_id) -> void {
+		region.schedule_turn(being_id, std::max(1_tick, _reg->get<body>(being_id).cond.busy_time));
+	}
+}
@@ -0,0 +1,75 @@
+//! @file
+//! @copyright See <a href="LICENSE.txt">LICENSE.txt</a>.
+
+#pragma once
+
+#include "quantities/wall_time.hpp"
+#include "reg.hpp"
+#include "utility/task.hpp"
+
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+namespace ql {
+	struct region;
+
+	//! Runs the game logic of a region: advancing its time, updating bodies, letting beings take their turns, and
+	//! delivering the effects of all that to the beings that perceive them.
+	//! Drives both the HUD's game logic thread and headless runs.
+	struct simulation {
+		//! Cumulative wall time spent in each system of the simulation.
+		struct system_timings {
+			//! Region updates: section streaming and the light map.
+			sec region = 0.0_s;
+			//! Popping ready beings from the turn queue and updating their bodies.
+			sec bodies = 0.0_s;
+			//! Agents taking their turns.
+			sec turns = 0.0_s;
+			//! Delivering effects to the agents that perceive them.
+			sec effects = 0.0_s;
+		};
+
+		simulation(reg& reg, id region_id);
+
+		//! Seeds the calling thread's PRNG from the region, so that a simulation of the same region with the same input
+		//! plays out the same way. Call from the thread that runs the simulation, before the first tick.
+		auto seed_prng() const -> void;
+
+		//! Advances the region by a tick and lets each being whose turn has come act, in turn order.
+		//! @return Whether the tick was completed. If a turn suspends, such as the player's turn awaiting input, the
+		//! rest of the tick's turns are put off and this returns false. Once the suspended turn has been resumed by
+		//! whatever it was awaiting, the next call finishes the tick instead of starting a new one.
+		auto tick() -> bool;
+
+		//! The number of ticks completed.
+		auto tick_count() const -> std::size_t {
+			return _tick_count;
+		}
+
+		//! The time spent in each system so far.
+		auto timings() const -> system_timings const& {
+			return _timings;
+		}
+
+	private:
+		reg_ptr _reg;
+		id _region_id;
+
+		//! The beings whose turns have come this tick.
+		std::vector<id> _ready_being_ids;
+		//! The index into @p _ready_being_ids of the current or next turn.
+		std::size_t _turn_idx = 0;
+		//! The current turn, if it's suspended.
+		std::optional<task> _o_suspended_turn;
+
+		std::size_t _tick_count = 0;
+		system_timings _timings;
+
+		//! Delivers the effects added to @p region since the last delivery.
+		auto deliver_effects(region& region) -> void;
+
+		//! Schedules the next turn of @p being_id for when it's done with this one.
+		auto end_turn(region& region, id being_id) -> void;
+	};
+}
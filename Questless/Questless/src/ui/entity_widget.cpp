@@ -9,10 +9,6 @@
 #include "animation/scene_node.hpp"
 #include "animation/sprite_animation.hpp"
 #include "animation/still_image.hpp"
-#include "entities/beings/body.hpp"
-#include "entities/beings/body_part.hpp"
-#include "entities/objects/campfire.hpp"
-#include "reg.hpp"
 #include "rsrc/entity.hpp"
 #include "rsrc/particle.hpp"
 
@@ -20,18 +16,17 @@
 
 namespace ql {
 	entity_widget::entity_widget( //
-		reg& reg,
 		rsrc::entity const& entity_resources,
 		rsrc::particle const& particle_resources,
-		world_view::entity_view entity_view)
-		: _reg{&reg}
-		, _entity_resources{&entity_resources}
+		world_view::entity_view entity_view,
+		entity_look const& look)
+		: _entity_resources{&entity_resources}
 		, _particle_resources{&particle_resources}
 		, _ev{entity_view} //
 	{
-		_ani = [this]() -> uptr<animation> {
+		_ani = [&]() -> uptr<animation> {
 			if (_ev.perception >= 25_perception) {
-				if (_reg->has<campfire>(_ev.id)) {
+				if (std::holds_alternative<entity_look::campfire>(look.value)) {
 					auto firewood = umake<still_image>(_entity_resources->txtr.firewood);
 					firewood->set_relative_origin({0.5f, 0.5f}, true);
 
@@ -49,7 +44,7 @@ namespace ql {
 					ani->front_children.push_back(std::move(flame));
 
 					return ani;
-				} else if (auto body = _reg->try_get<ql::body>(_ev.id)) {
+				} else if (auto being = std::get_if<entity_look::being>(&look.value)) {
 					// Sprite animation
 					auto scene_node = umake<ql::scene_node>(umake<sprite_animation>( //
 						ql::sprite_sheet{_entity_resources->ss.human, {3, 1}},
@@ -62,11 +57,9 @@ namespace ql {
 						sprite_animation::start_time::random));
 
 					// Bleeding animation
-					auto total_bleeding = 0.0_blood_per_tick;
-					body->for_all_parts([&](body_part const& part) { total_bleeding += part.stats.bleeding.cur; });
-					if (total_bleeding > 0.0_blood_per_tick) {
+					if (being->bleeding > 0.0_blood_per_tick) {
 						// Severity of bleeding is the rate of blood loss over the being's base vitality.
-						auto const severity = total_bleeding / body->stats.a.vitality.base;
+						auto const severity = being->bleeding / being->base_vitality;
 						// Converts the severity of bleeding to drops of animated blood per second.
 						constexpr auto conversion_factor = bleeding::drops{5.0} / 1.0_s / (1.0_blood_per_tick / 1_hp);
 						scene_node->front_children.push_back(
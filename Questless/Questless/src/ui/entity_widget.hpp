@@ -6,24 +6,38 @@
 #include "widget.hpp"
 
 #include "entities/beings/world_view.hpp"
-#include "reg.hpp"
+#include "quantities/misc.hpp"
 #include "rsrc/entity_fwd.hpp"
 #include "rsrc/particle_fwd.hpp"
 #include "utility/reference.hpp"
 
 #include <optional>
+#include <variant>
 
 namespace ql {
 	struct animation;
 
+	//! What the player sees of an entity beyond its entity view, copied from the registry on the game logic thread.
+	struct entity_look {
+		struct unknown {};
+		struct campfire {};
+		struct being {
+			//! The total bleeding of the being's body parts.
+			blood_per_tick bleeding;
+			health base_vitality;
+		};
+		std::variant<unknown, campfire, being> value;
+	};
+
 	//! Allows interaction with an entity.
 	struct entity_widget : widget {
 		//! @param entity_view A view of the entity this widget interfaces with.
+		//! @param look How the entity looks.
 		entity_widget( //
-			reg& reg,
 			rsrc::entity const& entity_resources,
 			rsrc::particle const& particle_resources,
-			world_view::entity_view entity_view);
+			world_view::entity_view entity_view,
+			entity_look const& look);
 
 		auto get_size() const -> view::vector final;
 
@@ -34,8 +48,6 @@ namespace ql {
 		auto get_position() const -> view::point final;
 
 	private:
-		reg_ptr _reg;
-
 		rsrc::entity_ptr _entity_resources;
 		rsrc::particle_ptr _particle_resources;
 
@@ -10,20 +10,20 @@ namespace ql {
 
 	//! @todo Is there a DRYer way to initialize the item widgets?
 
-	hotbar::hotbar(reg& reg, rsrc::item const& item_resources, rsrc::spell const& spell_resources)
+	hotbar::hotbar(rsrc::item const& item_resources, rsrc::spell const& spell_resources)
 		: _item_resources{&item_resources}
 		, _spell_resources{&spell_resources}
 		, _item_widgets{//
-			  item_widget{reg, item_resources, spell_resources},
-			  item_widget{reg, item_resources, spell_resources},
-			  item_widget{reg, item_resources, spell_resources},
-			  item_widget{reg, item_resources, spell_resources},
-			  item_widget{reg, item_resources, spell_resources},
-			  item_widget{reg, item_resources, spell_resources},
-			  item_widget{reg, item_resources, spell_resources},
-			  item_widget{reg, item_resources, spell_resources},
-			  item_widget{reg, item_resources, spell_resources},
-			  item_widget{reg, item_resources, spell_resources}}//
+			  item_widget{item_resources, spell_resources},
+			  item_widget{item_resources, spell_resources},
+			  item_widget{item_resources, spell_resources},
+			  item_widget{item_resources, spell_resources},
+			  item_widget{item_resources, spell_resources},
+			  item_widget{item_resources, spell_resources},
+			  item_widget{item_resources, spell_resources},
+			  item_widget{item_resources, spell_resources},
+			  item_widget{item_resources, spell_resources},
+			  item_widget{item_resources, spell_resources}}//
 	{}
 
 	auto hotbar::get_size() const -> view::vector {
@@ -100,7 +100,20 @@ namespace ql {
 	}
 
 	auto hotbar::set_item(size_t idx, std::optional<id> o_item_id) -> void {
-		_item_widgets[idx].set_o_item_id(o_item_id);
+		if (o_item_id) {
+			if (auto it = _item_looks.find(*o_item_id); it != _item_looks.end()) {
+				_item_widgets[idx].set_item(*o_item_id, it->second);
+				return;
+			}
+		}
+		_item_widgets[idx].clear_item();
+	}
+
+	auto hotbar::set_item_looks(std::unordered_map<id, item_look> item_looks) -> void {
+		_item_looks = std::move(item_looks);
+		for (size_t idx = 0; idx < _item_widgets.size(); ++idx) {
+			set_item(idx, _item_widgets[idx].get_o_item_id());
+		}
 	}
 
 	auto hotbar::set_on_click(std::function<void(std::optional<id>, view::point)> handler) -> void {
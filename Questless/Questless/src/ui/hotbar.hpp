@@ -9,6 +9,7 @@
 #include "reg.hpp"
 
 #include <optional>
+#include <unordered_map>
 
 namespace ql {
 	//! Holds items for ready use.
@@ -16,7 +17,7 @@ namespace ql {
 		//! The maximum number of items in the hotbar.
 		static constexpr std::size_t item_count = 10;
 
-		hotbar(reg& reg, rsrc::item const& item_resources, rsrc::spell const& spell_resources);
+		hotbar(rsrc::item const& item_resources, rsrc::spell const& spell_resources);
 
 		auto get_size() const -> view::vector final;
 
@@ -32,9 +33,13 @@ namespace ql {
 
 		auto on_mouse_move(view::point mouse_position) -> void final;
 
-		//! Sets the item ID of the @p idx item widget to @p o_item_id.
+		//! Sets the item ID of the @p idx item widget to @p o_item_id. Items without a look are cleared.
 		auto set_item(size_t idx, std::optional<id> o_item_id) -> void;
 
+		//! Updates how the player's items look to @p item_looks and re-renders the hotbar. Items that are no longer in
+		//! @p item_looks are removed from the hotbar.
+		auto set_item_looks(std::unordered_map<id, item_look> item_looks) -> void;
+
 		//! Copies @p handler to the @p on_click handler for each of this hotbar's item widgets.
 		auto set_on_click(std::function<void(std::optional<id>, view::point)> handler) -> void;
 
@@ -46,6 +51,7 @@ namespace ql {
 		view::point _mouse_position;
 
 		std::array<item_widget, item_count> _item_widgets;
+		std::unordered_map<id, item_look> _item_looks;
 		size_t _most_recent_idx = 0;
 
 		sf::Texture _slot_texture;
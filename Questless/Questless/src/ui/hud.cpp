@@ -5,12 +5,19 @@
 
 #include "dialog/list_dialog.hpp"
 
-#include "agents/actions.hpp"
 #include "agents/agent.hpp"
+#include "effects/effect.hpp"
 #include "entities/beings/body.hpp"
+#include "entities/beings/body_part.hpp"
+#include "entities/objects/campfire.hpp"
 #include "items/equipment.hpp"
+#include "items/inventory.hpp"
+#include "items/magic/gatestone.hpp"
+#include "items/magic/scroll.hpp"
+#include "items/weapons/arrow.hpp"
 #include "items/weapons/bow.hpp"
 #include "items/weapons/quarterstaff.hpp"
+#include "items/weapons/quiver.hpp"
 #include "rsrc/hud.hpp"
 #include "world/region.hpp"
 
@@ -21,25 +28,68 @@
 #include <range/v3/view/enumerate.hpp>
 #include <range/v3/view/take.hpp>
 
+#include <cassert>
+#include <utility>
+
 namespace ql {
 	namespace {
 		sf::Vector2i const item_icon_size{55, 55};
+
+		auto get_entity_look(reg& reg, id entity_id) -> entity_look {
+			if (reg.has<campfire>(entity_id)) {
+				return {entity_look::campfire{}};
+			} else if (auto body = reg.try_get<ql::body>(entity_id)) {
+				auto total_bleeding = 0.0_blood_per_tick;
+				body->for_all_parts([&](body_part const& part) { total_bleeding += part.stats.bleeding.cur; });
+				return {entity_look::being{total_bleeding, body->stats.a.vitality.base}};
+			}
+			return {};
+		}
+
+		auto get_item_look(reg& reg, id item_id) -> item_look {
+			item_look result;
+			if (auto bow = reg.try_get<ql::bow>(item_id)) {
+				result.value = item_look::bow{bow->nocked_arrow_id.has_value()};
+			} else if (reg.has<quarterstaff>(item_id)) {
+				result.value = item_look::quarterstaff{};
+			} else if (reg.has<quiver>(item_id)) {
+				result.value = item_look::quiver{};
+			} else if (reg.has<arrow>(item_id)) {
+				result.value = item_look::arrow{};
+			} else if (auto scroll = reg.try_get<ql::scroll>(item_id)) {
+				result.value = item_look::scroll{scroll->spell};
+			} else if (auto gatestone = reg.try_get<ql::gatestone>(item_id)) {
+				result.value =
+					item_look::gatestone{gatestone->color, gatestone->charge.get(), gatestone->charge.upper_bound()};
+			}
+			if (auto equipment = reg.try_get<ql::equipment>(item_id)) { result.o_equipped = equipment->equipped(); }
+			return result;
+		}
 	}
 
+	struct hud::perceived_effect {
+		effects::effect effect;
+		//! The vitality of the effect's target, if any.
+		health target_vitality;
+	};
+
 	hud::hud( //
 		reg& reg,
 		uptr<widget>& root,
 		rsrc::fonts const& fonts,
 		id region_id,
-		id player_id)
+		id player_id,
+		uptr<session_recorder> recorder)
 		: _reg{&reg}
 		, _root{root}
 		, _rsrc{fonts}
 		, _region_id{region_id}
 		, _player_id{player_id}
-		, _world_widget{reg, rsrc::world_widget{_rsrc.entity, _rsrc.fonts, _rsrc.particle, _rsrc.tile}}
-		, _hotbar{reg, _rsrc.item, _rsrc.spell}
-		, _inv{reg.get<inventory>(player_id), _hotbar}
+		, _world_widget{rsrc::world_widget{_rsrc.entity, _rsrc.fonts, _rsrc.particle, _rsrc.tile}}
+		, _hotbar{_rsrc.item, _rsrc.spell}
+		, _inv{_hotbar}
+		, _simulation{reg, region_id}
+		, _recorder{std::move(recorder)}
 		, _state{state::player_input}
 		, _game_logic_thread{make_game_logic_thread()} //
 	{
@@ -55,26 +105,25 @@ namespace ql {
 			}
 		});
 
+		// Render the initial world view. The game logic thread is still waiting, so take the snapshot right away.
+		publish_snapshot();
+		_snapshots.update();
+		present(_snapshots.current());
+
 		{ // Initialize hotbar with as many items as possible.
-			auto& inv = reg.get<inventory>(_player_id);
-			for (auto [idx, item] : ranges::views::enumerate(inv.item_ids) | ranges::views::take(hotbar::item_count)) {
+			auto const& item_ids = _snapshots.current().player_item_ids;
+			for (auto [idx, item] : ranges::views::enumerate(item_ids) | ranges::views::take(hotbar::item_count)) {
 				_hotbar.set_item(idx, item);
 			}
 		}
 
-		// Render the initial world view.
-		_world_widget.render_view(world_view{*_reg, _player_id});
-
 		// Begin game loop.
-		_state.store(state::game_loop);
+		set_state(state::game_loop);
 	}
 
 	hud::~hud() {
-		// Pass the turn so the game loop can finish its current iteration.
-		_pass_promise.set_value();
-
 		// Inform the game loop that the game is ending.
-		_state.store(state::ending);
+		set_state(state::ending);
 
 		// Await the game loop.
 		_game_logic_thread.join();
@@ -85,13 +134,44 @@ namespace ql {
 	}
 
 	auto hud::render_effect(effects::effect const& effect) -> void {
-		_world_widget.render_effect(effect);
+		// Read what rendering the effect needs from the registry here, so the UI thread doesn't have to.
+		auto target_vitality = 100_hp;
+		if (auto injury = std::get_if<effects::injury>(&effect.value)) {
+			// Assume vitality = 100 if the being no longer exists to check.
+			if (auto target_body = _reg->try_get<body>(injury->target_being_id)) {
+				target_vitality = target_body->parts[injury->target_part_idx].stats.a.vitality.cur;
+			}
+		}
+		// If the UI thread has fallen this far behind, the player can do without seeing the effect.
+		_effects.try_push(umake<perceived_effect>(perceived_effect{effect, target_vitality}));
+	}
+
+	auto hud::command_awaitable::await_ready() -> bool {
+		if (hud->_recorder) { hud->_recorder->checkpoint(*hud->_reg, hud->_region_id, hud->_simulation.tick_count()); }
+		o_command = hud->_commands.try_pop();
+		return o_command.has_value();
 	}
 
-	auto hud::pass_future() -> std::future<void> {
-		_world_widget.render_view(world_view{*_reg, _player_id});
-		_state.store(state::player_input);
-		return _pass_promise.get_future();
+	auto hud::command_awaitable::await_suspend(std::coroutine_handle<> awaiting) -> void {
+		// Show the player the current state of the world and wait for input, unless the game is ending.
+		hud->publish_snapshot();
+		hud->_command_continuation = awaiting;
+		auto expected = state::game_loop;
+		hud->_state.compare_exchange_strong(expected, state::player_input);
+		// A command issued since await_ready checked wouldn't have woken the game logic thread, so check again.
+		if (!hud->_commands.empty()) { hud->wake_for_commands(); }
+	}
+
+	auto hud::command_awaitable::await_resume() -> player_command {
+		// The game logic thread is only woken for input once there's a command to perform.
+		if (!o_command) { o_command = hud->_commands.try_pop(); }
+		assert(o_command);
+		if (hud->_recorder) { hud->_recorder->record(hud->_simulation.tick_count(), *o_command); }
+		return std::move(*o_command);
+	}
+
+	auto hud::next_command() -> command_awaitable {
+		return {this};
 	}
 
 	auto hud::get_size() const -> view::vector {
@@ -99,13 +179,23 @@ namespace ql {
 	}
 
 	auto hud::update(sec elapsed_time) -> void {
+		// Present the latest world snapshot, if there's a new one.
+		if (_snapshots.update()) { present(_snapshots.current()); }
+
+		// Render the effects the player has perceived since the last update.
+		while (auto o_effect = _effects.try_pop()) {
+			_world_widget.render_effect((*o_effect)->effect, (*o_effect)->target_vitality);
+		}
+
 		if (_item_dialog) {
 			_item_dialog->update(elapsed_time);
 		} else if (_show_inv) {
 			_inv.update(elapsed_time);
 		} else {
 			// Pass the turn as long as X is held.
-			if (sf::Keyboard::isKeyPressed(sf::Keyboard::X)) { return pass(); }
+			if (sf::Keyboard::isKeyPressed(sf::Keyboard::X) && _state.load() == state::player_input) {
+				return issue(commands::pass{});
+			}
 
 			_hotbar.update(elapsed_time);
 		}
@@ -151,37 +241,33 @@ namespace ql {
 			case sf::Keyboard::Z:
 				[[fallthrough]];
 			case sf::Keyboard::Return:
-				pass();
+				issue(commands::pass{});
 				return event_handled::yes;
 			// Movement commands.
 			case sf::Keyboard::Q:
-				move(*_reg, _player_id, hex_direction::ul, event.shift);
-				_world_widget.render_view(world_view{*_reg, _player_id});
+				issue(commands::move{hex_direction::ul, event.shift});
 				break;
 			case sf::Keyboard::W:
-				move(*_reg, _player_id, hex_direction::u, event.shift);
-				_world_widget.render_view(world_view{*_reg, _player_id});
+				issue(commands::move{hex_direction::u, event.shift});
 				break;
 			case sf::Keyboard::E:
-				move(*_reg, _player_id, hex_direction::ur, event.shift);
-				_world_widget.render_view(world_view{*_reg, _player_id});
+				issue(commands::move{hex_direction::ur, event.shift});
 				break;
 			case sf::Keyboard::A:
-				move(*_reg, _player_id, hex_direction::dl, event.shift);
-				_world_widget.render_view(world_view{*_reg, _player_id});
+				issue(commands::move{hex_direction::dl, event.shift});
 				break;
 			case sf::Keyboard::S:
-				move(*_reg, _player_id, hex_direction::d, event.shift);
-				_world_widget.render_view(world_view{*_reg, _player_id});
+				issue(commands::move{hex_direction::d, event.shift});
 				break;
 			case sf::Keyboard::D:
-				move(*_reg, _player_id, hex_direction::dr, event.shift);
-				_world_widget.render_view(world_view{*_reg, _player_id});
+				issue(commands::move{hex_direction::dr, event.shift});
 				break;
 			// Snap camera to player.
 			case sf::Keyboard::Space:
-				_world_widget.set_position(
-					view::point{} - tile_layout.to_world(_reg->get<location>(_player_id).coords) + view::point{});
+				if (auto const& o_view = _snapshots.current().view) {
+					auto const player_position = tile_layout.to_world(o_view->center.coords);
+					_world_widget.set_position(view::point{} - player_position + view::point{});
+				}
 				return event_handled::yes;
 			default:
 				return event_handled::no;
@@ -217,22 +303,18 @@ namespace ql {
 	auto hud::draw(sf::RenderTarget& target, sf::RenderStates states) const -> void {
 		target.draw(_world_widget, states);
 
-		//! @todo Condition bars.
-		// Blood
-		// Energy
-		// Satiety
-		// Alertness
+		//! @todo Condition bars instead of the condition readout.
 
 		target.draw(_hotbar, states);
 
 		// Draw the inventory if it's open.
 		if (_show_inv) { target.draw(_inv, states); }
 
+		auto const& snapshot = _snapshots.current();
+
 		{ // Draw the current time.
-			auto const& region = _reg->get<ql::region>(_region_id);
-			tick const time_of_day = region.time_of_day();
 			std::string time_name;
-			switch (region.period_of_day()) {
+			switch (snapshot.period_of_day) {
 				case period_of_day::morning:
 					time_name = "Morning";
 					break;
@@ -252,7 +334,7 @@ namespace ql {
 					time_name = "Dawn";
 					break;
 			}
-			std::string time_string = fmt::format("Time: {} ({}, {})", region.time(), time_of_day, time_name);
+			std::string time_string = fmt::format("Time: {} ({}, {})", snapshot.time, snapshot.time_of_day, time_name);
 			sf::Text time_text{time_string, _rsrc.fonts.firamono, 20};
 			time_text.setOutlineColor(sf::Color::Black);
 			time_text.setOutlineThickness(1.0f);
@@ -260,68 +342,114 @@ namespace ql {
 			time_text.setPosition({0, 50});
 			target.draw(time_text, states);
 		}
+
+		{ // Draw the player's condition.
+			auto const& cond = snapshot.player_cond;
+			std::string cond_string = fmt::format("Blood: {:.1f}  Energy: {}  Satiety: {:.1f}  Alertness: {:.1f}",
+				cond.blood.data,
+				cond.energy.get().data,
+				cond.satiety.get().data,
+				cond.alertness.get().data);
+			sf::Text cond_text{cond_string, _rsrc.fonts.firamono, 20};
+			cond_text.setOutlineColor(sf::Color::Black);
+			cond_text.setOutlineThickness(1.0f);
+			cond_text.setFillColor(sf::Color::White);
+			cond_text.setPosition({0, 75});
+			target.draw(cond_text, states);
+		}
 	}
 
 	auto hud::get_item_options(id item_id) -> std::vector<std::tuple<sf::String, std::function<void()>>> {
 		std::vector<std::tuple<sf::String, std::function<void()>>> result;
-		if (auto equipment = _reg->try_get<ql::equipment>(item_id)) {
-			if (equipment->equipped()) {
-				if (auto bow = _reg->try_get<ql::bow>(item_id)) {
-					if (bow->nocked_arrow_id) {
-						result.emplace_back("Draw", [bow] { bow->draw(); });
-						result.emplace_back("Loose", [bow] { bow->loose(); });
+		auto const& item_looks = _snapshots.current().item_looks;
+		auto const look_it = item_looks.find(item_id);
+		if (look_it != item_looks.end() && look_it->second.o_equipped) {
+			auto const& look = look_it->second;
+			if (*look.o_equipped) {
+				if (auto bow = std::get_if<item_look::bow>(&look.value)) {
+					if (bow->nocked) {
+						result.emplace_back("Draw", [this, item_id] { issue(commands::draw{item_id}); });
+						result.emplace_back("Loose", [this, item_id] { issue(commands::loose{item_id}); });
 					} else {
-						result.emplace_back("Nock", [bow] {
+						result.emplace_back("Nock", [] {
 							//! @todo Choose and nock arrow.
 							// bow->nock(arrow_id);
 						});
 					}
-				} else if (auto quarterstaff = _reg->try_get<ql::quarterstaff>(item_id)) {
-					result.emplace_back("Strike", [quarterstaff] { quarterstaff->strike(); });
-					result.emplace_back("Jab", [quarterstaff] { quarterstaff->jab(); });
+				} else if (std::holds_alternative<item_look::quarterstaff>(look.value)) {
+					result.emplace_back("Strike", [this, item_id] { issue(commands::strike{item_id}); });
+					result.emplace_back("Jab", [this, item_id] { issue(commands::jab{item_id}); });
 				}
-				result.emplace_back("Unequip", [equipment] { equipment->unequip(); });
+				result.emplace_back("Unequip", [this, item_id] { issue(commands::unequip{item_id}); });
 				return result;
 			} else {
-				result.emplace_back("Equip", [id = _player_id, equipment] { equipment->equip(id); });
+				result.emplace_back("Equip", [this, item_id] { issue(commands::equip{item_id}); });
 				// Fall through to the drop and toss actions.
 			}
 		}
-		result.emplace_back("Drop", [this, id = _player_id, item_id] { drop(*_reg, id, item_id); });
-		result.emplace_back("Toss", [this, id = _player_id, item_id] { toss(*_reg, id, item_id); });
+		result.emplace_back("Drop", [this, item_id] { issue(commands::drop{item_id}); });
+		result.emplace_back("Toss", [this, item_id] { issue(commands::toss{item_id}); });
 		return result;
 	}
 
-	auto hud::pass() -> void {
-		// Pass control by satisfying the current pass promise.
-		_pass_promise.set_value();
-		// Reassign the pass promise in preparation for next turn.
-		_pass_promise = std::promise<void>{};
-		// Resume the game loop.
-		_state.store(state::game_loop);
+	auto hud::present(render_snapshot const& snapshot) -> void {
+		if (snapshot.view) { _world_widget.render_view(*snapshot.view, snapshot.entity_looks); }
+		_hotbar.set_item_looks(snapshot.item_looks);
+		_inv.set_item_ids(snapshot.player_item_ids);
+	}
+
+	auto hud::issue(player_command command) -> void {
+		// If the game logic thread has fallen this far behind, the player can reissue the command later.
+		if (!_commands.try_push(std::move(command))) { return; }
+		wake_for_commands();
+	}
+
+	auto hud::set_state(state new_state) -> void {
+		_state.store(new_state);
+		_state.notify_one();
+	}
+
+	auto hud::wake_for_commands() -> void {
+		auto expected = state::player_input;
+		if (_state.compare_exchange_strong(expected, state::game_loop)) { _state.notify_one(); }
+	}
+
+	auto hud::publish_snapshot() -> void {
+		auto const& region = _reg->get<ql::region>(_region_id);
+		render_snapshot snapshot{world_view{*_reg, _player_id},
+			region.time(),
+			region.time_of_day(),
+			region.period_of_day(),
+			_reg->get<body>(_player_id).cond};
+
+		for (auto const& ev : snapshot.view->entity_views) {
+			snapshot.entity_looks.emplace(ev.id, get_entity_look(*_reg, ev.id));
+		}
+
+		auto const& item_ids = _reg->get<inventory>(_player_id).item_ids;
+		snapshot.player_item_ids.assign(item_ids.begin(), item_ids.end());
+		for (auto item_id : snapshot.player_item_ids) {
+			snapshot.item_looks.emplace(item_id, get_item_look(*_reg, item_id));
+		}
+
+		_snapshots.publish(std::move(snapshot));
 	}
 
 	auto hud::make_game_logic_thread() -> std::thread {
 		return std::thread{[this] {
+			// Game logic draws only on this thread's PRNG, so seeding it makes the session reproducible.
+			_simulation.seed_prng();
 			for (;;) {
 				switch (_state.load()) {
 					case state::player_input:
-						// Awaiting player input.
+						// Sleep until the player issues a command or the game ends.
+						_state.wait(state::player_input);
 						break;
-					case state::game_loop: {
-						constexpr auto elapsed_ticks = 1_tick;
-
-						// Update the region.
-						_reg->get<region>(_region_id).update(elapsed_ticks);
-
-						// For each being, update its body and allow it to act.
-						_reg->view<body, agent>().each([this, elapsed_ticks](body& body, agent& agent) {
-							body.update(elapsed_ticks);
-							agent.act().get();
-						});
-
+					case state::game_loop:
+						// A suspended player turn was woken by a command. Resume the turn to perform it.
+						if (_command_continuation) { std::exchange(_command_continuation, nullptr).resume(); }
+						_simulation.tick();
 						break;
-					}
 					case state::ending:
 						return;
 				}
@@ -8,14 +8,21 @@
 #include "hotbar.hpp"
 #include "inventory_widget.hpp"
 #include "panel.hpp"
+#include "render_snapshot.hpp"
 #include "view_space.hpp"
 #include "world_widget.hpp"
 
+#include "agents/player_command.hpp"
 #include "reg.hpp"
 #include "rsrc/hud.hpp"
+#include "session_recording.hpp"
+#include "simulation.hpp"
+#include "utility/spsc_queue.hpp"
+#include "utility/triple_buffer.hpp"
 
 #include <atomic>
-#include <future>
+#include <coroutine>
+#include <optional>
 #include <thread>
 
 namespace ql {
@@ -27,15 +34,35 @@ namespace ql {
 	//! The primary interface with the player during gameplay.
 	struct hud : widget {
 		//! @param player_id The ID of the player-controlled being.
-		hud(reg& reg, uptr<widget>& root, rsrc::fonts const& fonts, id region_id, id player_id);
+		//! @param recorder Records the session, if it's being recorded.
+		hud(reg& reg,
+			uptr<widget>& root,
+			rsrc::fonts const& fonts,
+			id region_id,
+			id player_id,
+			uptr<session_recorder> recorder = nullptr);
 
 		~hud();
 
-		//! Renders @p effect to be perceived by the player.
+		//! Renders @p effect to be perceived by the player. Only call from the game logic thread. The effect is
+		//! rendered on the UI thread during its next update, or dropped if the UI thread has fallen too far behind.
 		auto render_effect(effects::effect const& effect) -> void;
 
-		//! Gets a future which is set after the player passes the current turn.
-		auto pass_future() -> std::future<void>;
+		//! Awaitable that yields the player's next command, suspending the awaiting coroutine until there is one.
+		struct command_awaitable {
+			hud* hud;
+			std::optional<player_command> o_command = std::nullopt;
+
+			auto await_ready() -> bool;
+
+			auto await_suspend(std::coroutine_handle<> awaiting) -> void;
+
+			auto await_resume() -> player_command;
+		};
+
+		//! Awaits the player's next command. Only call from the game logic thread. If the player hasn't issued a
+		//! command yet, the awaiting coroutine suspends and is later resumed on the game logic thread.
+		auto next_command() -> command_awaitable;
 
 		//! Resets this HUD's stored player ID to @p player_id.
 		auto set_player_id(id player_id) -> void;
@@ -67,7 +94,19 @@ namespace ql {
 
 		id _region_id;
 		id _player_id{};
-		std::promise<void> _pass_promise;
+
+		//! The coroutine awaiting the player's next command, if any. Only accessed on the game logic thread.
+		std::coroutine_handle<> _command_continuation;
+
+		//! Commands from the UI thread, performed on the game logic thread during the player's turn.
+		spsc_queue<player_command, 64> _commands;
+
+		//! An effect perceived by the player, along with what's needed from the registry to render it.
+		struct perceived_effect;
+
+		//! Effects from the game logic thread, rendered on the UI thread. Effects aren't assignable, so they're queued
+		//! by pointer.
+		spsc_queue<uptr<perceived_effect>, 256> _effects;
 
 		rsrc::hud _rsrc;
 		view::point _position;
@@ -78,7 +117,16 @@ namespace ql {
 		uptr<list_dialog> _item_dialog;
 		bool _show_inv = false;
 
+		ql::simulation _simulation;
+
+		//! Records the player's commands, if the session is being recorded. Only used on the game logic thread.
+		uptr<session_recorder> _recorder;
+
+		//! Snapshots of the world published for the UI thread, which reads only the latest.
+		triple_buffer<render_snapshot> _snapshots;
+
 		enum class state { player_input, game_loop, ending };
+		//! The state of the game logic thread. Only change it through set_state so the logic thread is woken.
 		std::atomic<state> _state;
 		std::thread _game_logic_thread;
 
@@ -86,7 +134,22 @@ namespace ql {
 
 		auto get_item_options(id item_id) -> std::vector<std::tuple<sf::String, std::function<void()>>>;
 
-		auto pass() -> void;
+		//! Presents @p snapshot to the player. Only call from the UI thread.
+		auto present(render_snapshot const& snapshot) -> void;
+
+		//! Queues @p command to be performed during the player's turn. Only call from the UI thread. The command is
+		//! dropped if the queue is full.
+		auto issue(player_command command) -> void;
+
+		//! Publishes a snapshot of the world for the UI thread. Only call from the game logic thread, or before the
+		//! game loop begins.
+		auto publish_snapshot() -> void;
+
+		//! Sets the game logic state to @p new_state and wakes the game logic thread if it's waiting for player input.
+		auto set_state(state new_state) -> void;
+
+		//! Wakes the game logic thread to perform commands if it's waiting for player input.
+		auto wake_for_commands() -> void;
 
 		auto make_game_logic_thread() -> std::thread;
 	};
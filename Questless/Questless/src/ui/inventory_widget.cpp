@@ -12,9 +12,8 @@ namespace ql {
 		constexpr view::vector item_icon_size{55.0_px, 55.0_px};
 	}
 
-	inventory_widget::inventory_widget(inventory& inventory, hotbar& hotbar)
-		: _inv{&inventory}
-		, _hotbar{&hotbar} //
+	inventory_widget::inventory_widget(hotbar& hotbar)
+		: _hotbar{&hotbar} //
 	{
 		//! @todo Support item sorting (alphabetical or custom).
 		//! @todo Cache the displayed items (only need to regenerate list if a turn has been taken).
@@ -24,6 +23,10 @@ namespace ql {
 		return _size;
 	}
 
+	auto inventory_widget::set_item_ids(std::vector<id> item_ids) -> void {
+		_displayed_items = std::move(item_ids);
+	}
+
 	auto inventory_widget::update(sec /*elapsed_time*/) -> void {}
 
 	auto inventory_widget::draw(sf::RenderTarget& target, sf::RenderStates states) const -> void {
@@ -5,14 +5,19 @@
 
 #include "widget.hpp"
 
-#include "items/inventory.hpp"
+#include "reg.hpp"
+
+#include <vector>
 
 namespace ql {
 	struct hotbar;
 
 	//! Interfaces with an inventory.
 	struct inventory_widget : widget {
-		inventory_widget(inventory& inventory, hotbar& hotbar);
+		inventory_widget(hotbar& hotbar);
+
+		//! Sets the items this widget displays to those with IDs @p item_ids.
+		auto set_item_ids(std::vector<id> item_ids) -> void;
 
 		auto get_size() const -> view::vector final;
 
@@ -29,7 +34,6 @@ namespace ql {
 		auto on_mouse_move(view::point mouse_position) -> void final;
 
 	private:
-		gsl::not_null<inventory*> _inv;
 		gsl::not_null<hotbar*> _hotbar;
 		view::point _position;
 		view::vector _size;
@@ -12,15 +12,9 @@
 #include "animation/sprite_animation.hpp"
 #include "animation/still_image.hpp"
 #include "animation/still_shape.hpp"
-#include "items/magic/gatestone.hpp"
-#include "items/magic/scroll.hpp"
-#include "items/weapons/arrow.hpp"
-#include "items/weapons/bow.hpp"
-#include "items/weapons/quarterstaff.hpp"
-#include "items/weapons/quiver.hpp"
-#include "magic/spell.hpp"
 #include "rsrc/item.hpp"
 #include "rsrc/spell.hpp"
+#include "utility/unreachable.hpp"
 #include "utility/visitation.hpp"
 
 namespace ql {
@@ -37,8 +31,8 @@ namespace ql {
 		}
 	}
 
-	item_widget::item_widget(reg& reg, rsrc::item const& item_resources, rsrc::spell const& spell_resources)
-		: _reg{&reg}, _item_resources{&item_resources}, _spell_resources{&spell_resources} {}
+	item_widget::item_widget(rsrc::item const& item_resources, rsrc::spell const& spell_resources)
+		: _item_resources{&item_resources}, _spell_resources{&spell_resources} {}
 
 	item_widget::~item_widget() = default;
 
@@ -46,101 +40,105 @@ namespace ql {
 		return _o_item_id;
 	}
 
-	auto item_widget::set_o_item_id(std::optional<id> o_item_id) -> void {
-		// Assign and nullopt-check before proceeding.
-		_o_item_id = o_item_id;
-		if (!_o_item_id) { return; }
-		id item_id = *_o_item_id;
+	auto item_widget::set_item(id item_id, item_look const& look) -> void {
+		_o_item_id = item_id;
 
 		// Render item.
-		if (_reg->has<bow>(item_id)) {
-			_ani = umake<still_image>(_item_resources->bow);
-		} else if (_reg->has<quarterstaff>(item_id)) {
-			_ani = umake<still_image>(_item_resources->quarterstaff);
-		} else if (_reg->has<quiver>(item_id)) {
-			_ani = umake<still_image>(_item_resources->quiver);
-		} else if (_reg->has<arrow>(item_id)) {
-			_ani = umake<still_image>(_item_resources->arrow);
-		} else if (auto scroll = _reg->try_get<ql::scroll>(item_id)) {
-			if (scroll->spell == std::nullopt) {
-				_ani = umake<still_image>(_item_resources->blank_scroll);
-			} else {
-				auto node = umake<scene_node>(umake<still_image>(_item_resources->written_scroll));
-				node->front_children.push_front(animate_spell(*_spell_resources, *scroll->spell));
-				_ani = std::move(node);
-			}
-		} else if (auto gatestone = _reg->try_get<ql::gatestone>(item_id)) {
-			if (gatestone->charge.get() == 0_mp) {
-				_ani = umake<still_image>(_item_resources->uncharged_gatestone);
-			} else {
-				// Create gatestone still.
-				auto gatestone_still = umake<still_image>(_item_resources->charged_gatestone);
-				sf::Color const draw_color_factor = [&] {
-					sf::Color result;
-					switch (gatestone->color) {
-						case magic::color::white:
-							result = sf::Color::White;
-							break;
-						case magic::color::black:
-							result = sf::Color{51, 51, 51};
-							break;
-						case magic::color::green:
-							result = sf::Color::Green;
-							break;
-						case magic::color::red:
-							result = sf::Color::Red;
-							break;
-						case magic::color::blue:
-							result = sf::Color::Blue;
-							break;
-						case magic::color::yellow:
-							result = sf::Color::Yellow;
-							break;
-						case magic::color::violet:
-							result = sf::Color{192, 0, 255};
-							break;
-						case magic::color::orange:
-							result = sf::Color{255, 192, 0};
-							break;
-						default:
-							UNREACHABLE;
+		_ani = match(
+			look.value,
+			[&](item_look::bow const&) -> uptr<animation> { return umake<still_image>(_item_resources->bow); },
+			[&](item_look::quarterstaff const&) -> uptr<animation> {
+				return umake<still_image>(_item_resources->quarterstaff);
+			},
+			[&](item_look::quiver const&) -> uptr<animation> { return umake<still_image>(_item_resources->quiver); },
+			[&](item_look::arrow const&) -> uptr<animation> { return umake<still_image>(_item_resources->arrow); },
+			[&](item_look::scroll const& scroll) -> uptr<animation> {
+				if (scroll.o_spell == std::nullopt) {
+					return umake<still_image>(_item_resources->blank_scroll);
+				} else {
+					auto node = umake<scene_node>(umake<still_image>(_item_resources->written_scroll));
+					node->front_children.push_front(animate_spell(*_spell_resources, *scroll.o_spell));
+					return node;
+				}
+			},
+			[&](item_look::gatestone const& gatestone) -> uptr<animation> {
+				if (gatestone.charge == 0_mp) {
+					return umake<still_image>(_item_resources->uncharged_gatestone);
+				} else {
+					// Create gatestone still.
+					auto gatestone_still = umake<still_image>(_item_resources->charged_gatestone);
+					sf::Color const draw_color_factor = [&] {
+						sf::Color result;
+						switch (gatestone.color) {
+							case magic::color::white:
+								result = sf::Color::White;
+								break;
+							case magic::color::black:
+								result = sf::Color{51, 51, 51};
+								break;
+							case magic::color::green:
+								result = sf::Color::Green;
+								break;
+							case magic::color::red:
+								result = sf::Color::Red;
+								break;
+							case magic::color::blue:
+								result = sf::Color::Blue;
+								break;
+							case magic::color::yellow:
+								result = sf::Color::Yellow;
+								break;
+							case magic::color::violet:
+								result = sf::Color{192, 0, 255};
+								break;
+							case magic::color::orange:
+								result = sf::Color{255, 192, 0};
+								break;
+							default:
+								UNREACHABLE;
+						}
+						result.a = static_cast<sf::Uint8>((255 * gatestone.charge / gatestone.capacity).data);
+						return result;
+					}();
+					gatestone_still->set_color(draw_color_factor);
+
+					// Create scene node with gatestone still.
+					auto node = umake<scene_node>(std::move(gatestone_still));
+
+					//! @todo Clean up the charge bar. Remove magic numbers.
+
+					{ // Overlay charge bar background.
+						auto charge_bar_background = umake<sf::RectangleShape>(sf::Vector2f{6, 55});
+						charge_bar_background->setFillColor(sf::Color::Black);
+						node->front_children.push_front(umake<still_shape>(std::move(charge_bar_background)));
 					}
-					result.a = static_cast<sf::Uint8>((255 * gatestone->charge.get() / gatestone->charge.upper_bound()).data);
-					return result;
-				}();
-				gatestone_still->set_color(draw_color_factor);
-
-				// Create scene node with gatestone still.
-				auto node = umake<scene_node>(std::move(gatestone_still));
-
-				//! @todo Clean up the charge bar. Remove magic numbers.
 
-				{ // Overlay charge bar background.
-					auto charge_bar_background = umake<sf::RectangleShape>(sf::Vector2f{6, 55});
-					charge_bar_background->setFillColor(sf::Color::Black);
-					node->front_children.push_front(umake<still_shape>(std::move(charge_bar_background)));
-				}
+					{ // Overlay charge bar foreground.
+						float const height = 55.f * gatestone.charge.data / gatestone.capacity.data;
+						auto charge_bar_foreground = umake<sf::RectangleShape>(sf::Vector2f{6, height});
+						charge_bar_foreground->setFillColor(draw_color_factor);
+						charge_bar_foreground->setOutlineColor(sf::Color::Black);
+						charge_bar_foreground->setOutlineThickness(1);
+						node->front_children.push_front(umake<still_shape>(std::move(charge_bar_foreground)));
+					}
 
-				{ // Overlay charge bar foreground.
-					float const height = 55.f * gatestone->charge.get().data / gatestone->charge.upper_bound().data;
-					auto charge_bar_foreground = umake<sf::RectangleShape>(sf::Vector2f{6, height});
-					charge_bar_foreground->setFillColor(draw_color_factor);
-					charge_bar_foreground->setOutlineColor(sf::Color::Black);
-					charge_bar_foreground->setOutlineThickness(1);
-					node->front_children.push_front(umake<still_shape>(std::move(charge_bar_foreground)));
+					return node;
 				}
-
-				_ani = std::move(node);
-			}
-		} else {
-			// No item components recognized. Fallback to an "error" sprite.
-			_ani = umake<still_image>(_item_resources->error);
-		}
+			},
+			[&](item_look::unknown const&) -> uptr<animation> {
+				// No item components recognized. Fallback to an "error" sprite.
+				return umake<still_image>(_item_resources->error);
+			});
 
 		// Set/reset position, in case item ID was unset last time set_position() was called.
 		_ani->setPosition(to_sfml(_position));
 	}
 
+	auto item_widget::clear_item() -> void {
+		_o_item_id = std::nullopt;
+		_ani = nullptr;
+	}
+
 	auto item_widget::get_size() const -> view::vector {
 		return size;
 	}
@@ -5,16 +5,43 @@
 
 #include "widget.hpp"
 
+#include "magic/color.hpp"
+#include "magic/spell.hpp"
+#include "quantities/misc.hpp"
 #include "reg.hpp"
 #include "rsrc/item_fwd.hpp"
 #include "rsrc/spell_fwd.hpp"
 #include "utility/reference.hpp"
 
 #include <optional>
+#include <variant>
 
 namespace ql {
 	struct animation;
 
+	//! What the player sees of an item, copied from the registry on the game logic thread.
+	struct item_look {
+		struct unknown {};
+		struct bow {
+			bool nocked;
+		};
+		struct quarterstaff {};
+		struct quiver {};
+		struct arrow {};
+		struct scroll {
+			std::optional<magic::spell> o_spell;
+		};
+		struct gatestone {
+			magic::color color;
+			mana charge;
+			mana capacity;
+		};
+		std::variant<unknown, bow, quarterstaff, quiver, arrow, scroll, gatestone> value;
+
+		//! Whether the item is equipped, or nullopt if it isn't equipment.
+		std::optional<bool> o_equipped = std::nullopt;
+	};
+
 	//! Allows interaction with an item.
 	struct item_widget : widget {
 		//! Item widgets have a fixed size.
@@ -23,15 +50,18 @@ namespace ql {
 		//! Invoked when this widget is clicked, passing the item's ID, if any, and the mouse click coordinates.
 		std::function<void(std::optional<id>, view::point)> on_click;
 
-		item_widget(reg& reg, rsrc::item const& item_resources, rsrc::spell const& spell_resources);
+		item_widget(rsrc::item const& item_resources, rsrc::spell const& spell_resources);
 
 		~item_widget();
 
 		//! The ID of the item this widget currently interfaces with, if any.
 		auto get_o_item_id() const -> std::optional<id>;
 
-		//! Sets this widget's item ID to @p item_id.
-		auto set_o_item_id(std::optional<id> o_item_id) -> void;
+		//! Sets this widget's item to the item with ID @p item_id, which looks like @p look.
+		auto set_item(id item_id, item_look const& look) -> void;
+
+		//! Removes this widget's item, if any.
+		auto clear_item() -> void;
 
 		auto get_size() const -> view::vector final;
 
@@ -44,8 +74,6 @@ namespace ql {
 		auto on_mouse_press(sf::Event::MouseButtonEvent const& event) -> event_handled final;
 
 	private:
-		reg_ptr _reg;
-
 		rsrc::item_ptr _item_resources;
 		rsrc::spell_ptr _spell_resources;
 
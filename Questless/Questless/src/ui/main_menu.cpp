@@ -12,15 +12,22 @@
 #include "world/spawn_player.hpp"
 
 namespace ql {
-	main_menu::main_menu(reg& reg, uptr<widget>& root, rsrc::fonts const& fonts) : _reg{&reg}, _root{root} {
+	main_menu::main_menu(reg& reg,
+		uptr<widget>& root,
+		rsrc::fonts const& fonts,
+		std::uint64_t world_seed,
+		uptr<session_recorder> recorder)
+		: _reg{&reg}
+		, _root{root} //
+	{
 		//! @todo Implement main menu stuff instead of just immediately switching into the game.
 
 		// Create the main region.
-		id region_id = make_region(reg, reg.create(), "Region 1");
+		id region_id = make_region(reg, reg.create(), "Region 1", world_seed);
 		// Spawn the player into the main region.
 		auto player_id = create_and_spawn_player(reg, region_id);
 		// Create HUD.
-		_hud = umake<hud>(reg, root, fonts, region_id, player_id);
+		_hud = umake<hud>(reg, root, fonts, region_id, player_id, std::move(recorder));
 	}
 
 	main_menu::~main_menu() = default;
@@ -7,14 +7,23 @@
 
 #include "reg.hpp"
 #include "rsrc/fonts_fwd.hpp"
+#include "session_recording.hpp"
 #include "utility/reference.hpp"
 
+#include <cstdint>
+
 namespace ql {
 	struct hud;
 
 	//! The scene for the main menu.
 	struct main_menu : widget {
-		main_menu(reg& reg, uptr<widget>& root, rsrc::fonts const& fonts);
+		//! @param world_seed The seed from which to generate the world.
+		//! @param recorder Records the session, if it's being recorded.
+		main_menu(reg& reg,
+			uptr<widget>& root,
+			rsrc::fonts const& fonts,
+			std::uint64_t world_seed,
+			uptr<session_recorder> recorder);
 
 		~main_menu();
 
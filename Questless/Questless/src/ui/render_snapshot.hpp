@@ -0,0 +1,42 @@
+//! @file
+//! @copyright See <a href="LICENSE.txt">LICENSE.txt</a>.
+
+#pragma once
+
+#include "entity_widget.hpp"
+#include "item_widget.hpp"
+
+#include "entities/beings/body_cond.hpp"
+#include "entities/beings/world_view.hpp"
+#include "quantities/game_time.hpp"
+#include "world/region.hpp"
+
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace ql {
+	//! An immutable copy of the world state the HUD presents, so the UI thread never reads the registry while the
+	//! game logic thread is changing it.
+	struct render_snapshot {
+		//! What the player perceives. Empty until the first snapshot is published.
+		std::optional<world_view> view;
+
+		//! The time in the player's region.
+		tick time = 0_tick;
+		tick time_of_day = 0_tick;
+		ql::period_of_day period_of_day = ql::period_of_day::morning;
+
+		//! The condition of the player's body.
+		body_cond player_cond{};
+
+		//! How each entity in @p view looks.
+		std::unordered_map<id, entity_look> entity_looks;
+
+		//! The IDs of the items in the player's inventory.
+		std::vector<id> player_item_ids;
+
+		//! How each of the player's items looks.
+		std::unordered_map<id, item_look> item_looks;
+	};
+}
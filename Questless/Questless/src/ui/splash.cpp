@@ -22,10 +22,16 @@ namespace ql {
 		constexpr sec duration = fade_out_duration + fade_in_duration;
 	}
 
-	splash::splash(reg& reg, uptr<widget>& root, rsrc::fonts const& fonts)
+	splash::splash(reg& reg,
+		uptr<widget>& root,
+		rsrc::fonts const& fonts,
+		std::uint64_t world_seed,
+		uptr<session_recorder> recorder)
 		: _reg{&reg}
 		, _root{root}
 		, _fonts{&fonts}
+		, _world_seed{world_seed}
+		, _recorder{std::move(recorder)}
 		, _flame_sound{_rsrc.sfx.flame} //
 	{
 		_fade_shader.loadFromFile("resources/shaders/fade.frag", sf::Shader::Type::Fragment);
@@ -139,7 +145,7 @@ namespace ql {
 
 	auto splash::end_scene() -> void {
 		_flame_sound.stop();
-		auto menu = umake<main_menu>(*_reg, _root, *_fonts);
+		auto menu = umake<main_menu>(*_reg, _root, *_fonts, _world_seed, std::move(_recorder));
 		// Initialize size and position.
 		menu->on_parent_resize(_size);
 		menu->set_position(_position);
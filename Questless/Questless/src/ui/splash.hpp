@@ -8,14 +8,23 @@
 #include "reg.hpp"
 #include "rsrc/fonts_fwd.hpp"
 #include "rsrc/splash.hpp"
+#include "session_recording.hpp"
 #include "utility/reference.hpp"
 #include "view_space.hpp"
 
+#include <cstdint>
+
 namespace ql {
 	//! The splash screen.
 	struct splash : widget {
 		//! @param root A reference to the root UI element of the game, used to change scenes when the splash screen ends.
-		splash(reg& reg, uptr<widget>& root, rsrc::fonts const& fonts);
+		//! @param world_seed The seed from which to generate the world when the game starts.
+		//! @param recorder Records the session, if it's being recorded.
+		splash(reg& reg,
+			uptr<widget>& root,
+			rsrc::fonts const& fonts,
+			std::uint64_t world_seed,
+			uptr<session_recorder> recorder);
 
 		auto get_size() const -> view::vector final;
 
@@ -41,6 +50,9 @@ namespace ql {
 		uptr<widget>& _root;
 		rsrc::fonts_ptr _fonts;
 
+		std::uint64_t _world_seed;
+		uptr<session_recorder> _recorder;
+
 		rsrc::splash _rsrc;
 		sf::Shader _fade_shader;
 		view::point _position;
@@ -9,13 +9,11 @@
 #include "world/terrain.hpp"
 
 namespace ql {
-	tile_widget::tile_widget(reg& reg, rsrc::tile const& resources, world_view::tile_view const& tile_view)
-		: _reg{&reg}
-		, _rsrc{&resources}
+	tile_widget::tile_widget(rsrc::tile const& resources, world_view::tile_view const& tile_view)
+		: _rsrc{&resources}
 		, _tv{tile_view} //
 	{
 		_ani = [&] {
-			auto const terrain = reg.get<ql::terrain>(_tv.id);
 			sf::ConvexShape cs;
 			{ // Add offset points.
 				cs.setPointCount(6);
@@ -27,7 +25,7 @@ namespace ql {
 			cs.setOutlineColor(sf::Color::Black);
 			cs.setOutlineThickness(1);
 			auto shape = std::make_unique<still_shape>(std::make_unique<sf::ConvexShape>(cs));
-			switch (terrain) {
+			switch (_tv.terrain) {
 				case terrain::dirt:
 					shape->shape->setTexture(&_rsrc->txtr.dirt);
 					break;
@@ -6,7 +6,6 @@
 #include "widget.hpp"
 
 #include "entities/beings/world_view.hpp"
-#include "reg.hpp"
 #include "rsrc/tile_fwd.hpp"
 #include "utility/reference.hpp"
 
@@ -18,7 +17,7 @@ namespace ql {
 	//! Allows interaction with a tile in the world.
 	struct tile_widget : widget {
 		//! @param entity_view A view of the tile this widget interfaces with.
-		tile_widget(reg& reg, rsrc::tile const& resources, world_view::tile_view const& tile_view);
+		tile_widget(rsrc::tile const& resources, world_view::tile_view const& tile_view);
 
 		auto get_size() const -> view::vector final;
 
@@ -29,8 +28,6 @@ namespace ql {
 		auto get_position() const -> view::point final;
 
 	private:
-		reg_ptr _reg;
-
 		rsrc::tile_ptr _rsrc;
 
 		world_view::tile_view _tv;
@@ -12,7 +12,6 @@
 
 #include "damage/damage.hpp"
 #include "effects/effect.hpp"
-#include "entities/beings/body_part.hpp"
 #include "entities/beings/world_view.hpp"
 #include "entities/entity.hpp"
 #include "rsrc/fonts.hpp"
@@ -32,9 +31,8 @@ namespace ql {
 
 	using namespace view::literals;
 
-	world_widget::world_widget(reg& reg, rsrc::world_widget const& resources)
-		: _reg{&reg}
-		, _rsrc{resources}
+	world_widget::world_widget(rsrc::world_widget const& resources)
+		: _rsrc{resources}
 		, _arrow_sound{_rsrc.sfx.arrow}
 		, _hit_sound{_rsrc.sfx.hit}
 		, _pierce_sound{_rsrc.sfx.pierce}
@@ -42,9 +40,9 @@ namespace ql {
 		, _telescope_sound{_rsrc.sfx.telescope} //
 	{}
 
-	void world_widget::render_view(world_view const& view) {
+	void world_widget::render_view(world_view const& view, std::unordered_map<id, entity_look> const& entity_looks) {
 		render_terrain(view);
-		render_entities(view);
+		render_entities(view, entity_looks);
 	}
 
 	auto world_widget::get_size() const -> view::vector {
@@ -139,13 +137,15 @@ namespace ql {
 	auto world_widget::render_terrain(world_view const& view) -> void {
 		_tile_widgets.clear();
 		for (auto const& tv : view.tile_views) {
-			auto& tile_widget = _tile_widgets.try_emplace(tv.id, *_reg, _rsrc.tile, tv).first->second;
+			auto& tile_widget = _tile_widgets.try_emplace(tv.coords, _rsrc.tile, tv).first->second;
 			tile_widget.on_parent_resize(_size);
 			tile_widget.set_position(tv.position);
 		}
 	}
 
-	auto world_widget::render_entities(world_view const& view) -> void {
+	auto world_widget::render_entities(world_view const& view, std::unordered_map<id, entity_look> const& entity_looks)
+		-> void //
+	{
 		using ev = world_view::entity_view;
 
 		_entity_widgets.clear();
@@ -156,13 +156,16 @@ namespace ql {
 		});
 		// Render sorted entities.
 		for (auto const& ev : sorted_entity_views) {
-			auto& entity_widget = _entity_widgets.try_emplace(ev.id, *_reg, _rsrc.entity, _rsrc.particle, ev).first->second;
+			auto const look_it = entity_looks.find(ev.id);
+			auto const look = look_it == entity_looks.end() ? entity_look{} : look_it->second;
+			auto& entity_widget =
+				_entity_widgets.try_emplace(ev.id, _rsrc.entity, _rsrc.particle, ev, look).first->second;
 			entity_widget.on_parent_resize(_size);
 			entity_widget.set_position(ev.position);
 		}
 	}
 
-	auto world_widget::render_effect(effects::effect const& effect) -> void {
+	auto world_widget::render_effect(effects::effect const& effect, health target_vitality) -> void {
 		match(
 			effect.value,
 			[&](effects::arrow_attack const& e) {
@@ -172,15 +175,9 @@ namespace ql {
 				_arrow_sound.play();
 			},
 			[&](effects::injury const& e) {
-				body_part const* const target_part = _reg->try_get<body_part>(e.target_part_id);
-				// Assume vitality = 100 if being no longer exists to check.
-				auto const target_vitality = target_part ? target_part->stats.a.vitality.cur : 100_hp;
-				//! @todo Pass along the vitality in the event object if it's needed here (to avoid having to make
-				//! up a number).
-
 				view::point const position = tile_layout.to_world(e.origin);
 
-				for (auto const& part : e.damage.parts) {
+				e.damage.for_each_part([&](dmg::damage const& part) {
 					static constexpr sec text_duration = 2.0_s;
 
 					auto const& font = _rsrc.fonts.firamono;
@@ -240,7 +237,7 @@ namespace ql {
 								text_duration, font, std::to_string(rot.data), sf::Color{96, 96, 96}, sf::Color::White, 1.0f));
 							_effect_animations.back()->setPosition(view::to_sfml(position));
 						});
-				}
+				});
 			},
 			[&](effects::lightning_bolt const& e) {
 				constexpr int n = 35;
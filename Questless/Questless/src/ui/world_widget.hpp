@@ -22,11 +22,12 @@ namespace ql {
 
 	//! Handles interaction with the world, as the player sees it.
 	struct world_widget : widget {
-		world_widget(reg& reg, rsrc::world_widget const& resources);
+		world_widget(rsrc::world_widget const& resources);
 
 		//! Updates the world renderer's world view.
 		//! @param world_view The new world view to render.
-		auto render_view(world_view const& view) -> void;
+		//! @param entity_looks How the entities in @p view look. Entities missing from the map are drawn as unknown.
+		auto render_view(world_view const& view, std::unordered_map<id, entity_look> const& entity_looks) -> void;
 
 		auto get_size() const -> view::vector final;
 
@@ -52,11 +53,11 @@ namespace ql {
 		//! Clears the current highlight predicate so that no tiles are highlighted.
 		auto clear_highlight_predicate() -> void;
 
-		auto render_effect(effects::effect const& effect) -> void;
+		//! Renders @p effect.
+		//! @param target_vitality The vitality of the effect's target, if any, which scales how much blood it draws.
+		auto render_effect(effects::effect const& effect, health target_vitality) -> void;
 
 	private:
-		reg_ptr _reg;
-
 		rsrc::world_widget _rsrc;
 		sf::Sound _arrow_sound;
 		sf::Sound _hit_sound;
@@ -69,7 +70,7 @@ namespace ql {
 
 		std::optional<view::point> _o_drag_start;
 
-		std::unordered_map<id, tile_widget> _tile_widgets;
+		std::unordered_map<tile_hex_point, tile_widget> _tile_widgets;
 		std::unordered_map<id, entity_widget> _entity_widgets;
 
 		std::vector<uptr<animation>> _effect_animations;
@@ -78,7 +79,7 @@ namespace ql {
 
 		auto render_terrain(world_view const& view) -> void;
 
-		auto render_entities(world_view const& view) -> void;
+		auto render_entities(world_view const& view, std::unordered_map<id, entity_look> const& entity_looks) -> void;
 
 		auto draw(sf::RenderTarget& target, sf::RenderStates states) const -> void final;
 	};
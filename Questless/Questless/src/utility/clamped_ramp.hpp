@@ -0,0 +1,96 @@
+//! @file
+//! @copyright See <a href="LICENSE.txt">LICENSE.txt</a>.
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace ql {
+	//! The sequence clamp(offset + slope * k, 0, 1) for k = 1, 2, ..., i.e. a linear ramp that saturates at 0 and 1.
+	//! Sums and threshold counts over any prefix of it are computed in constant time, for advancing per-tick processes
+	//! by many ticks at once.
+	struct clamped_ramp {
+		double offset;
+		double slope;
+
+		//! The value at step @p k.
+		auto at(std::int64_t k) const -> double {
+			return std::clamp(offset + slope * static_cast<double>(k), 0.0, 1.0);
+		}
+
+		//! The sum of the values at steps 1 through @p n.
+		auto sum(std::int64_t n) const -> double {
+			if (n <= 0) { return 0.0; }
+			if (slope == 0.0) { return static_cast<double>(n) * at(0); }
+			// A falling ramp is one minus a rising one.
+			if (slope < 0.0) { return static_cast<double>(n) - clamped_ramp{1.0 - offset, -slope}.sum(n); }
+
+			// Steps 1 through last_zero are clamped to 0, and steps first_one through n are clamped to 1.
+			std::int64_t const last_zero = clamp_step(std::floor(-offset / slope), 0, n);
+			std::int64_t const first_one = clamp_step(std::ceil((1.0 - offset) / slope), last_zero + 1, n + 1);
+			auto const ramp_count = static_cast<double>(first_one - last_zero - 1);
+			double const ramp_step_sum = ramp_count * static_cast<double>(last_zero + first_one) / 2.0;
+			return ramp_count * offset + slope * ramp_step_sum + static_cast<double>(n + 1 - first_one);
+		}
+
+		//! The number of steps from 1 through @p n whose values are less than @p threshold.
+		auto count_below(double threshold, std::int64_t n) const -> std::int64_t {
+			if (n <= 0 || threshold <= 0.0) { return 0; }
+			if (threshold > 1.0) { return n; }
+			// For thresholds in (0, 1], clamping doesn't change which side of the threshold a value is on.
+			if (slope == 0.0) { return offset < threshold ? n : 0; }
+			double const crossing = (threshold - offset) / slope;
+			if (slope > 0.0) { return clamp_step(std::ceil(crossing) - 1.0, 0, n); }
+			return n - clamp_step(std::floor(crossing), 0, n);
+		}
+
+	private:
+		//! @p step clamped to [@p min, @p max] and converted to an integer, safely even if @p step is huge or infinite.
+		static auto clamp_step(double step, std::int64_t min, std::int64_t max) -> std::int64_t {
+			return static_cast<std::int64_t>(std::clamp(step, static_cast<double>(min), static_cast<double>(max)));
+		}
+	};
+}
+
+#include "doctest_wrapper/test.hpp"
+
+TEST_CASE("[clamped_ramp] operations") {
+	using namespace ql;
+
+	auto const check_against_steps = [](clamped_ramp const& ramp, std::int64_t n) {
+		double sum = 0.0;
+		std::int64_t below_half = 0;
+		std::int64_t below_one = 0;
+		for (std::int64_t k = 1; k <= n; ++k) {
+			sum += ramp.at(k);
+			if (ramp.at(k) < 0.5) { ++below_half; }
+			if (ramp.at(k) < 1.0) { ++below_one; }
+		}
+		CHECK_EQ(ramp.sum(n), doctest::Approx(sum));
+		CHECK_EQ(ramp.count_below(0.5, n), below_half);
+		CHECK_EQ(ramp.count_below(1.0, n), below_one);
+	};
+
+	SUBCASE("rising through both bounds") {
+		check_against_steps({-0.35, 0.1}, 30);
+	}
+	SUBCASE("falling through both bounds") {
+		check_against_steps({1.27, -0.03}, 100);
+	}
+	SUBCASE("flat") {
+		check_against_steps({0.25, 0.0}, 10);
+	}
+	SUBCASE("saturated") {
+		check_against_steps({2.0, 0.5}, 10);
+	}
+	SUBCASE("steps beyond the end") {
+		check_against_steps({0.0, 0.001}, 10);
+	}
+	SUBCASE("no steps") {
+		clamped_ramp const ramp{0.5, 0.1};
+		CHECK_EQ(ramp.sum(0), 0.0);
+		CHECK_EQ(ramp.count_below(1.0, 0), 0);
+	}
+}
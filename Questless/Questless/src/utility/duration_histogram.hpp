@@ -0,0 +1,128 @@
+//! @file
+//! @copyright See <a href="LICENSE.txt">LICENSE.txt</a>.
+
+#pragma once
+
+#include "quantities/wall_time.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <ostream>
+
+namespace ql {
+	//! Counts durations in buckets whose widths grow with their magnitude, in the style of an HDR histogram, so that
+	//! percentiles over any number of samples can be read off in constant space with bounded relative error.
+	struct duration_histogram {
+		//! Records the duration @p duration. Negative durations count as zero.
+		auto record(sec duration) -> void {
+			auto const micros = static_cast<std::uint64_t>(std::max(0.0f, std::round(duration.data * 1'000'000.0f)));
+			++_counts[bucket_index(std::min(micros, max_micros))];
+			++_count;
+			_max_micros = std::max(_max_micros, micros);
+		}
+
+		//! Removes all recorded durations.
+		auto clear() -> void {
+			_counts.fill(0);
+			_count = 0;
+			_max_micros = 0;
+		}
+
+		//! The number of recorded durations.
+		auto count() const -> std::uint64_t {
+			return _count;
+		}
+
+		//! The longest recorded duration, or zero if none has been recorded.
+		auto max() const -> sec {
+			return to_sec(_max_micros);
+		}
+
+		//! The duration that @p percent of recorded durations are less than or equal to, within about 2%, or zero if
+		//! none has been recorded.
+		//! @param percent The percentile, in [0, 100].
+		auto percentile(double percent) const -> sec {
+			if (_count == 0) { return 0.0_s; }
+			auto const rank = std::clamp<std::uint64_t>(
+				static_cast<std::uint64_t>(std::ceil(percent / 100.0 * static_cast<double>(_count))), 1, _count);
+			std::uint64_t cumulative_count = 0;
+			for (std::size_t i = 0; i < bucket_count; ++i) {
+				cumulative_count += _counts[i];
+				if (cumulative_count >= rank) {
+					// The highest occupied bucket contains the maximum, which is known exactly.
+					return cumulative_count == _count ? max() : to_sec(bucket_midpoint(i));
+				}
+			}
+			return max();
+		}
+
+		//! Writes the 50th, 95th, and 99th percentiles, the maximum, and the count to @p out as a CSV row, with
+		//! durations in milliseconds.
+		auto write_csv_row(std::ostream& out) const -> void {
+			auto const ms = [](sec duration) { return duration.data * 1000.0f; };
+			out << ms(percentile(50)) << ',' << ms(percentile(95)) << ',' << ms(percentile(99)) << ',' << ms(max())
+				<< ',' << _count << '\n';
+		}
+
+	private:
+		//! Each power of two is split into this many sub-buckets, so a bucket's midpoint is within 1 / 2^6 ~ 2% of its
+		//! values.
+		static constexpr int sub_bucket_bits = 5;
+		static constexpr std::uint64_t sub_bucket_count = std::uint64_t{1} << sub_bucket_bits;
+
+		//! Durations are counted in microseconds, up to about 12 days.
+		static constexpr std::uint64_t max_micros = (std::uint64_t{1} << 40) - 1;
+
+		static constexpr std::size_t bucket_count = (40 - sub_bucket_bits + 1) * sub_bucket_count;
+
+		std::array<std::uint64_t, bucket_count> _counts{};
+		std::uint64_t _count = 0;
+		std::uint64_t _max_micros = 0;
+
+		static constexpr auto to_sec(std::uint64_t micros) -> sec {
+			return sec{static_cast<float>(micros) / 1'000'000.0f};
+		}
+
+		//! The index of the bucket containing @p micros. Values below @p sub_bucket_count get their own buckets.
+		static constexpr auto bucket_index(std::uint64_t micros) -> std::size_t {
+			if (micros < sub_bucket_count) { return static_cast<std::size_t>(micros); }
+			int const shift = std::bit_width(micros) - 1 - sub_bucket_bits;
+			return static_cast<std::size_t>((shift + 1) * sub_bucket_count + (micros >> shift) - sub_bucket_count);
+		}
+
+		//! The middle of the range of values in the bucket at @p index.
+		static constexpr auto bucket_midpoint(std::size_t index) -> std::uint64_t {
+			if (index < sub_bucket_count) { return index; }
+			int const shift = static_cast<int>(index / sub_bucket_count) - 1;
+			std::uint64_t const lower_bound = (sub_bucket_count + index % sub_bucket_count) << shift;
+			return lower_bound + ((std::uint64_t{1} << shift) >> 1);
+		}
+	};
+}
+
+#include "doctest_wrapper/test.hpp"
+
+TEST_CASE("[duration_histogram] operations") {
+	using namespace ql;
+
+	duration_histogram histogram;
+	CHECK_EQ(histogram.count(), 0);
+	CHECK_EQ(histogram.percentile(50), 0.0_s);
+
+	// 1 ms to 100 ms, in 1 ms steps.
+	for (int i = 1; i <= 100; ++i) {
+		histogram.record(sec{i / 1000.0f});
+	}
+	CHECK_EQ(histogram.count(), 100);
+	CHECK_EQ(histogram.max().data, doctest::Approx(0.1));
+	CHECK_EQ(histogram.percentile(50).data, doctest::Approx(0.05).epsilon(0.04));
+	CHECK_EQ(histogram.percentile(99).data, doctest::Approx(0.099).epsilon(0.04));
+	CHECK_EQ(histogram.percentile(100), histogram.max());
+
+	histogram.clear();
+	CHECK_EQ(histogram.count(), 0);
+	CHECK_EQ(histogram.max(), 0.0_s);
+}
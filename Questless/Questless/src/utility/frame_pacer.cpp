@@ -0,0 +1,38 @@
+//! @file
+//! @copyright See <a href="LICENSE.txt">LICENSE.txt</a>.
+
+#include "frame_pacer.hpp"
+
+#include <algorithm>
+#include <thread>
+
+namespace ql {
+	frame_pacer::frame_pacer(sec frame_duration, sec max_lag)
+		: _frame_duration{std::chrono::duration_cast<clock::duration>(to_chrono_sec(frame_duration))}
+		, _max_lag{std::chrono::duration_cast<clock::duration>(to_chrono_sec(max_lag))} {}
+
+	auto frame_pacer::wait() -> sec {
+		auto const sleep_duration = _deadline - clock::now() - _spin_margin;
+		if (sleep_duration > clock::duration::zero()) {
+			auto const sleep_start = clock::now();
+			std::this_thread::sleep_for(sleep_duration);
+			calibrate(clock::now() - sleep_start - sleep_duration);
+		}
+		while (clock::now() < _deadline) {
+			std::this_thread::yield();
+		}
+
+		auto const now = clock::now();
+		sec const frame_duration = to_sec(now - _frame_start);
+		_frame_start = now;
+		_deadline = std::max(_deadline, now - _max_lag) + _frame_duration;
+		return frame_duration;
+	}
+
+	auto frame_pacer::calibrate(clock::duration overshoot) -> void {
+		// Leave a quarter again as much room as the observed overshoot, and otherwise decay by 1/16 per frame.
+		_spin_margin = std::clamp(std::max(overshoot + overshoot / 4, _spin_margin - _spin_margin / 16),
+			min_spin_margin,
+			_frame_duration);
+	}
+}
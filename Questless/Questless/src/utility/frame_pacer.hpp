@@ -0,0 +1,41 @@
+//! @file
+//! @copyright See <a href="LICENSE.txt">LICENSE.txt</a>.
+
+#pragma once
+
+#include "quantities/wall_time.hpp"
+
+namespace ql {
+	//! Holds a loop to a fixed frame duration. Waits by sleeping until shortly before each frame's deadline and then
+	//! spinning the rest of the way, since sleeps alone can overshoot by as much as a scheduler quantum.
+	struct frame_pacer {
+		//! @param frame_duration The target duration of each frame.
+		//! @param max_lag How far behind schedule the pacer can fall before it stops trying to catch up.
+		frame_pacer(sec frame_duration, sec max_lag);
+
+		//! Waits until the current frame's deadline and then starts the next frame.
+		//! @return The duration of the frame that just ended.
+		auto wait() -> sec;
+
+	private:
+		//! Don't spin for less than this long, to absorb small sleep overshoots that haven't been observed yet.
+		static constexpr clock::duration min_spin_margin = std::chrono::microseconds{200};
+
+		clock::duration _frame_duration;
+		clock::duration _max_lag;
+
+		//! When the current frame started.
+		clock::time_point _frame_start = clock::now();
+
+		//! When the current frame should end. Frames that run long pull later deadlines earlier, so that short frames
+		//! can make up for them, up to @p _max_lag.
+		clock::time_point _deadline = _frame_start + _frame_duration;
+
+		//! How long before the deadline to stop sleeping and start spinning. Rises immediately to cover the largest
+		//! recent sleep overshoot and decays slowly otherwise.
+		clock::duration _spin_margin = std::chrono::milliseconds{2};
+
+		//! Adjusts the spin margin after a sleep that overshot its requested duration by @p overshoot.
+		auto calibrate(clock::duration overshoot) -> void;
+	};
+}
@@ -8,12 +8,15 @@
 
 #include "world/coordinates.hpp"
 
+#include <cstdint>
 #include <random>
+#include <string_view>
 #include <type_traits>
 
 namespace ql {
-	//! A pseudorandom number generator.
-	inline auto prng = [] {
+	//! A pseudorandom number generator. Each thread has its own, seeded nondeterministically unless @p seed_prng is
+	//! called on that thread.
+	inline thread_local auto prng = [] {
 		std::random_device rng{};
 		constexpr auto n = sizeof(std::mt19937_64::result_type) * std::mt19937_64::state_size / sizeof(unsigned);
 		std::array<unsigned, n> seed_data;
@@ -22,6 +25,64 @@ namespace ql {
 		return std::mt19937_64{seed};
 	}();
 
+	//! Reseeds the calling thread's @p prng with @p seed, so that the thread's use of it can be reproduced.
+	inline auto seed_prng(std::uint64_t seed) -> void {
+		prng.seed(seed);
+	}
+
+	//! Combines @p key with @p value into a new key, for deriving independent random streams from structured keys.
+	constexpr auto combine_keys(std::uint64_t key, std::uint64_t value) -> std::uint64_t {
+		// SplitMix64 finalizer over the combined bits.
+		std::uint64_t x = key ^ (value + 0x9e3779b97f4a7c15ull + (key << 6) + (key >> 2));
+		x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+		x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+		return x ^ (x >> 31);
+	}
+
+	//! A key derived from @p name, stable across runs and platforms.
+	constexpr auto string_key(std::string_view name) -> std::uint64_t {
+		// 64-bit FNV-1a.
+		std::uint64_t result = 0xcbf29ce484222325ull;
+		for (char const c : name) {
+			result = (result ^ static_cast<unsigned char>(c)) * 0x100000001b3ull;
+		}
+		return result;
+	}
+
+	//! A counter-based pseudorandom number generator. Each output is a pure function of the key and the number of
+	//! values drawn so far, so streams with different keys are independent and can be drawn from on any thread, and
+	//! the same key always reproduces the same stream.
+	//! @note Standard distributions are implementation-defined. Use the member sampling functions where results must be
+	//! reproducible across platforms.
+	struct keyed_prng {
+		using result_type = std::uint64_t;
+
+		constexpr explicit keyed_prng(std::uint64_t key) : _key{key} {}
+
+		static constexpr auto min() -> result_type {
+			return 0;
+		}
+
+		static constexpr auto max() -> result_type {
+			return UINT64_MAX;
+		}
+
+		constexpr auto operator()() -> result_type {
+			return combine_keys(_key, _counter++);
+		}
+
+		//! A value in [@p min, @p max] with a uniform distribution.
+		constexpr auto uniform(int min, int max) -> int {
+			auto const range = static_cast<std::uint64_t>(static_cast<std::int64_t>(max) - min) + 1;
+			// The modulo bias is negligible for the small ranges used in generation.
+			return static_cast<int>(static_cast<std::int64_t>(min) + static_cast<std::int64_t>((*this)() % range));
+		}
+
+	private:
+		std::uint64_t _key;
+		std::uint64_t _counter = 0;
+	};
+
 	//! True or false with equal probability.
 	inline auto coin_flip() -> bool {
 		return std::uniform_int<int>(0, 1)(prng) == 0;
@@ -83,3 +144,20 @@ namespace ql {
 		return box.position + view::vector{uniform(view::px{0.0}, width(box)), uniform(view::px{0.0}, height(box))};
 	}
 }
+
+#include "doctest_wrapper/test.hpp"
+
+TEST_CASE("[keyed_prng] reproducibility") {
+	ql::keyed_prng prng1{ql::combine_keys(42, 7)};
+	ql::keyed_prng prng2{ql::combine_keys(42, 7)};
+	ql::keyed_prng prng3{ql::combine_keys(42, 8)};
+	bool differs = false;
+	for (int i = 0; i < 16; ++i) {
+		auto const value = prng1.uniform(-3, 3);
+		CHECK(-3 <= value);
+		CHECK(value <= 3);
+		CHECK_EQ(value, prng2.uniform(-3, 3));
+		differs = differs || prng1() != prng3();
+	}
+	CHECK(differs);
+}
@@ -0,0 +1,77 @@
+//! @file
+//! @copyright See <a href="LICENSE.txt">LICENSE.txt</a>.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <optional>
+#include <utility>
+
+namespace ql {
+	//! A fixed-capacity, lock-free FIFO queue from one producer thread to one consumer thread.
+	//! @tparam T The element type. Must be default-constructible.
+	//! @tparam Capacity The maximum number of elements in the queue. Must be a power of two.
+	template <typename T, std::size_t Capacity>
+	struct spsc_queue {
+		static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two.");
+
+		static constexpr std::size_t capacity = Capacity;
+
+		//! Adds @p value to the back of the queue, unless the queue is full. Only call from the producer thread.
+		//! @return Whether @p value was added.
+		auto try_push(T value) -> bool {
+			auto const tail = _tail.load(std::memory_order_relaxed);
+			if (tail - _head.load(std::memory_order_acquire) == Capacity) { return false; }
+			_slots[tail % Capacity] = std::move(value);
+			_tail.store(tail + 1, std::memory_order_release);
+			return true;
+		}
+
+		//! Removes and returns the front of the queue, or nullopt if the queue is empty. Only call from the consumer
+		//! thread.
+		auto try_pop() -> std::optional<T> {
+			auto const head = _head.load(std::memory_order_relaxed);
+			if (head == _tail.load(std::memory_order_acquire)) { return std::nullopt; }
+			std::optional<T> result{std::move(_slots[head % Capacity])};
+			_head.store(head + 1, std::memory_order_release);
+			return result;
+		}
+
+		//! Whether the queue is empty. Only reliable on the consumer thread, where the queue can only grow.
+		auto empty() const -> bool {
+			return _head.load(std::memory_order_relaxed) == _tail.load(std::memory_order_acquire);
+		}
+
+	private:
+		std::array<T, Capacity> _slots{};
+
+		// The indices are on separate cache lines so the producer and consumer don't contend for them.
+
+		//! The total number of elements popped.
+		alignas(64) std::atomic<std::size_t> _head = 0;
+		//! The total number of elements pushed.
+		alignas(64) std::atomic<std::size_t> _tail = 0;
+	};
+}
+
+#include "doctest_wrapper/test.hpp"
+
+TEST_CASE("[spsc_queue] operations") {
+	ql::spsc_queue<int, 2> queue;
+	CHECK(queue.empty());
+	CHECK_FALSE(queue.try_pop());
+
+	CHECK(queue.try_push(1));
+	CHECK(queue.try_push(2));
+	CHECK_FALSE(queue.try_push(3));
+	CHECK_FALSE(queue.empty());
+
+	CHECK_EQ(queue.try_pop(), 1);
+	CHECK(queue.try_push(4));
+	CHECK_EQ(queue.try_pop(), 2);
+	CHECK_EQ(queue.try_pop(), 4);
+	CHECK(queue.empty());
+	CHECK_FALSE(queue.try_pop());
+}
@@ -0,0 +1,143 @@
+//! @file
+//! @copyright See <a href="LICENSE.txt">LICENSE.txt</a>.
+
+#pragma once
+
+#include <coroutine>
+#include <exception>
+#include <utility>
+
+namespace ql {
+	//! A lazily started coroutine with no result, such as an action that spans several steps or waits on input.
+	//! A default-constructed task is already complete, so functions that finish synchronously can return one without
+	//! allocating a coroutine frame or synchronizing with anything.
+	struct [[nodiscard]] task {
+		struct promise_type {
+			//! The coroutine awaiting this one, resumed when this one completes.
+			std::coroutine_handle<> continuation = std::noop_coroutine();
+
+			std::exception_ptr exception;
+
+			auto get_return_object() -> task {
+				return task{std::coroutine_handle<promise_type>::from_promise(*this)};
+			}
+
+			auto initial_suspend() noexcept -> std::suspend_always {
+				return {};
+			}
+
+			auto final_suspend() noexcept {
+				struct final_awaiter {
+					auto await_ready() noexcept -> bool {
+						return false;
+					}
+
+					auto await_suspend(std::coroutine_handle<promise_type> handle) noexcept -> std::coroutine_handle<> {
+						return handle.promise().continuation;
+					}
+
+					auto await_resume() noexcept -> void {}
+				};
+				return final_awaiter{};
+			}
+
+			auto return_void() -> void {}
+
+			auto unhandled_exception() -> void {
+				exception = std::current_exception();
+			}
+		};
+
+		task() = default;
+
+		task(task&& that) noexcept : _handle{std::exchange(that._handle, nullptr)} {}
+
+		auto operator=(task&& that) noexcept -> task& {
+			if (this != &that) {
+				destroy();
+				_handle = std::exchange(that._handle, nullptr);
+			}
+			return *this;
+		}
+
+		~task() {
+			destroy();
+		}
+
+		//! Whether this task has run to completion.
+		auto done() const -> bool {
+			return !_handle || _handle.done();
+		}
+
+		//! Runs this task until it completes or suspends on something other than another task.
+		auto start() -> void {
+			if (!done()) { _handle.resume(); }
+			rethrow_if_failed();
+		}
+
+		//! Rethrows the exception that escaped this task, if any.
+		auto rethrow_if_failed() const -> void {
+			if (done() && _handle && _handle.promise().exception) {
+				std::rethrow_exception(_handle.promise().exception);
+			}
+		}
+
+		//! Awaits this task from another coroutine, starting it and resuming the awaiting coroutine on completion.
+		auto operator co_await() && noexcept {
+			struct awaiter {
+				std::coroutine_handle<promise_type> handle;
+
+				auto await_ready() const noexcept -> bool {
+					return !handle || handle.done();
+				}
+
+				auto await_suspend(std::coroutine_handle<> awaiting) noexcept -> std::coroutine_handle<> {
+					handle.promise().continuation = awaiting;
+					return handle;
+				}
+
+				auto await_resume() const -> void {
+					if (handle && handle.promise().exception) { std::rethrow_exception(handle.promise().exception); }
+				}
+			};
+			return awaiter{_handle};
+		}
+
+	private:
+		std::coroutine_handle<promise_type> _handle = nullptr;
+
+		explicit task(std::coroutine_handle<promise_type> handle) : _handle{handle} {}
+
+		auto destroy() -> void {
+			if (_handle) {
+				_handle.destroy();
+				_handle = nullptr;
+			}
+		}
+	};
+}
+
+#include "doctest_wrapper/test.hpp"
+
+TEST_CASE("[task] operations") {
+	SUBCASE("default-constructed tasks are complete") {
+		CHECK(ql::task{}.done());
+	}
+	SUBCASE("tasks start lazily and run awaited tasks to completion") {
+		int steps = 0;
+		auto inner = [&]() -> ql::task {
+			++steps;
+			co_return;
+		};
+		auto outer = [&]() -> ql::task {
+			co_await inner();
+			co_await ql::task{};
+			++steps;
+		};
+		auto task = outer();
+		CHECK_EQ(steps, 0);
+		task.start();
+		CHECK(task.done());
+		CHECK_EQ(steps, 2);
+	}
+}
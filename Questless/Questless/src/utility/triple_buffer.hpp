@@ -0,0 +1,75 @@
+//! @file
+//! @copyright See <a href="LICENSE.txt">LICENSE.txt</a>.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <utility>
+
+namespace ql {
+	//! Passes the latest of a series of values from one producer thread to one consumer thread without locking. The
+	//! producer never waits for the consumer and vice versa; values the consumer doesn't get to in time are skipped.
+	//! @tparam T The value type. Must be default-constructible.
+	template <typename T>
+	struct triple_buffer {
+		//! Makes @p value the latest value. Only call from the producer thread.
+		auto publish(T value) -> void {
+			_buffers[_back] = std::move(value);
+			// Swap the filled back buffer with the middle buffer, marking the middle buffer as fresh.
+			_back = _middle.exchange(_back | fresh_bit, std::memory_order_acq_rel) & index_mask;
+		}
+
+		//! Makes the latest published value current, if there is a newer one. Only call from the consumer thread.
+		//! @return Whether the current value changed.
+		auto update() -> bool {
+			if ((_middle.load(std::memory_order_relaxed) & fresh_bit) == 0) { return false; }
+			// Swap the front buffer with the fresh middle buffer, marking the middle buffer as stale.
+			_front = _middle.exchange(_front, std::memory_order_acq_rel) & index_mask;
+			return true;
+		}
+
+		//! The current value, as of the last successful @p update. Only call from the consumer thread.
+		auto current() const -> T const& {
+			return _buffers[_front];
+		}
+
+	private:
+		static constexpr std::uint8_t index_mask = 0b011;
+		static constexpr std::uint8_t fresh_bit = 0b100;
+
+		std::array<T, 3> _buffers{};
+
+		//! The index of the buffer between the producer and the consumer, plus a flag for whether it's unread.
+		std::atomic<std::uint8_t> _middle = 1;
+
+		//! The index of the buffer the producer writes to.
+		std::uint8_t _back = 2;
+
+		//! The index of the buffer the consumer reads from.
+		std::uint8_t _front = 0;
+	};
+}
+
+#include "doctest_wrapper/test.hpp"
+
+TEST_CASE("[triple_buffer] operations") {
+	ql::triple_buffer<int> buffer;
+	CHECK_EQ(buffer.current(), 0);
+	CHECK_FALSE(buffer.update());
+
+	buffer.publish(1);
+	CHECK_EQ(buffer.current(), 0);
+	CHECK(buffer.update());
+	CHECK_EQ(buffer.current(), 1);
+	CHECK_FALSE(buffer.update());
+
+	// Only the latest of several publications is seen.
+	buffer.publish(2);
+	buffer.publish(3);
+	CHECK(buffer.update());
+	CHECK_EQ(buffer.current(), 3);
+	CHECK_FALSE(buffer.update());
+	CHECK_EQ(buffer.current(), 3);
+}
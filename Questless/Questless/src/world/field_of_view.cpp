@@ -0,0 +1,153 @@
+//! @file
+//! @copyright See <a href="LICENSE.txt">LICENSE.txt</a>.
+
+#include "field_of_view.hpp"
+
+#include "region.hpp"
+
+#include "utility/unreachable.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <memory>
+#include <mutex>
+
+namespace ql {
+	namespace {
+		//! How much of the view each occupied tile lets through.
+		constexpr double occupant_transparency = 0.5;
+
+		//! A tile in a ray table, along with the index of its parent, the previous tile on the ray from the origin.
+		struct ray_cell {
+			int q;
+			int r;
+			std::size_t parent_idx;
+		};
+
+		//! A table of rays out from the origin. Cells are ordered by distance from the origin, so each cell's parent
+		//! precedes it, and the cells within any smaller radius form a prefix of the table. The first cell is the
+		//! origin.
+		using ray_table = std::vector<ray_cell>;
+
+		constexpr auto hex_length(int q, int r) -> int {
+			return (std::abs(q) + std::abs(r) + std::abs(q + r)) / 2;
+		}
+
+		//! The number of tiles within @p radius of a tile.
+		constexpr auto cell_count(int radius) -> std::size_t {
+			return static_cast<std::size_t>(1 + 3 * radius * (radius + 1));
+		}
+
+		//! The index of the offset (@p q, @p r) in a rhomboid of the given @p radius, in q-major order.
+		constexpr auto rhomboid_index(int q, int r, int radius) -> std::size_t {
+			return static_cast<std::size_t>((q + radius) * (2 * radius + 1) + r + radius);
+		}
+
+		auto make_ray_table(int radius) -> ray_table {
+			ray_table result;
+			result.reserve(cell_count(radius));
+			for (int q = -radius; q <= radius; ++q) {
+				for (int r = -radius; r <= radius; ++r) {
+					if (hex_length(q, r) <= radius) { result.push_back({q, r, 0}); }
+				}
+			}
+			std::stable_sort(result.begin(), result.end(), [](ray_cell const& a, ray_cell const& b) {
+				return hex_length(a.q, a.r) < hex_length(b.q, b.r);
+			});
+
+			std::vector<std::size_t> indices(rhomboid_index(radius, radius, radius) + 1);
+			for (std::size_t idx = 0; idx < result.size(); ++idx) {
+				indices[rhomboid_index(result[idx].q, result[idx].r, radius)] = idx;
+			}
+
+			constexpr std::array<std::array<int, 2>, 6> neighbor_offsets{
+				{{1, 0}, {0, 1}, {-1, 1}, {-1, 0}, {0, -1}, {1, -1}}};
+			for (auto& cell : result) {
+				int const length = hex_length(cell.q, cell.r);
+				if (length == 0) { continue; }
+
+				// The point one step back along the straight line to the origin, in cube coordinates. The nudge breaks
+				// ties consistently when the line runs exactly between two tiles.
+				double const scale = (length - 1) / static_cast<double>(length);
+				double const q = cell.q * scale + 1e-6;
+				double const r = cell.r * scale + 2e-6;
+				double const s = -(cell.q + cell.r) * scale - 3e-6;
+
+				// The parent is the neighbor one step closer to the origin that is nearest that point.
+				double best_distance = INFINITY;
+				for (auto const [dq, dr] : neighbor_offsets) {
+					int const nq = cell.q + dq;
+					int const nr = cell.r + dr;
+					if (hex_length(nq, nr) != length - 1) { continue; }
+					double const distance = (nq - q) * (nq - q) + (nr - r) * (nr - r) + (-nq - nr - s) * (-nq - nr - s);
+					if (distance < best_distance) {
+						best_distance = distance;
+						cell.parent_idx = indices[rhomboid_index(nq, nr, radius)];
+					}
+				}
+			}
+			return result;
+		}
+
+		//! A ray table covering at least @p radius. Tables are shared between threads and grown as needed.
+		auto get_ray_table(int radius) -> std::shared_ptr<ray_table const> {
+			static std::mutex mutex;
+			static std::shared_ptr<ray_table const> table = std::make_shared<ray_table const>(make_ray_table(0));
+			std::scoped_lock lock{mutex};
+			if (table->size() < cell_count(radius)) {
+				table = std::make_shared<ray_table const>(make_ray_table(radius));
+			}
+			return table;
+		}
+	}
+
+	auto inside_field_of_vision(tile_hex_point origin, hex_direction direction, tile_hex_point target) -> bool {
+		auto offset = target - origin;
+		switch (direction) {
+			case hex_direction::dr:
+				return offset.q >= 0_pace && offset.q + offset.r >= 0_pace;
+			case hex_direction::d:
+				return offset.r >= 0_pace && offset.q + offset.r >= 0_pace;
+			case hex_direction::dl:
+				return offset.q <= 0_pace && offset.r >= 0_pace;
+			case hex_direction::ul:
+				return offset.q <= 0_pace && offset.q + offset.r <= 0_pace;
+			case hex_direction::u:
+				return offset.r <= 0_pace && offset.q + offset.r <= 0_pace;
+			case hex_direction::ur:
+				return offset.q >= 0_pace && offset.r <= 0_pace;
+			default:
+				UNREACHABLE;
+		}
+	}
+
+	field_of_view::field_of_view(region const& region, tile_hex_point origin, pace radius)
+		: _origin{origin}
+		, _radius{radius}
+		, _occlusion(rhomboid_index(radius.data, radius.data, radius.data) + 1, 1.0) //
+	{
+		auto const table = get_ray_table(radius.data);
+		auto const count = cell_count(radius.data);
+
+		// How much of the view from the origin passes through each cell: the transparency at the cell times the cell's
+		// own transparency. Each cell is reached from its parent, so the whole field takes one pass over the table.
+		std::vector<double> passed(count);
+		auto cursor = region.cursor();
+		for (std::size_t idx = 0; idx < count; ++idx) {
+			auto const& cell = (*table)[idx];
+			double const transparency = idx == 0 ? 1.0 : passed[cell.parent_idx];
+			_occlusion[rhomboid_index(cell.q, cell.r, radius.data)] = 1.0 - transparency;
+
+			// The origin and target themselves don't occlude, so only cells passing the view on can block it.
+			bool const occupied = idx != 0 && cursor.entity_id_at(origin + tile_hex_vector{pace{cell.q}, pace{cell.r}});
+			passed[idx] = occupied ? transparency * occupant_transparency : transparency;
+		}
+	}
+
+	auto field_of_view::occlusion_at(tile_hex_point coords) const -> double {
+		auto const offset = coords - _origin;
+		if (offset.length() > _radius) { return 1.0; }
+		return _occlusion[rhomboid_index(offset.q.data, offset.r.data, _radius.data)];
+	}
+}
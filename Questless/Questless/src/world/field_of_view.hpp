@@ -0,0 +1,46 @@
+//! @file
+//! @copyright See <a href="LICENSE.txt">LICENSE.txt</a>.
+
+#pragma once
+
+#include "coordinates.hpp"
+
+#include <vector>
+
+namespace ql {
+	struct region;
+
+	//! Whether @p target is in the field of vision of a viewer at @p origin facing @p direction: the third of the plane
+	//! centered on @p direction.
+	auto inside_field_of_vision(tile_hex_point origin, hex_direction direction, tile_hex_point target) -> bool;
+
+	//! The occlusion of every tile within range of a viewpoint in a region.
+	//! @note Rays are drawn from a precomputed table in which each tile's ray extends the ray to its parent, the
+	//! neighboring tile one step closer to the origin and nearest the straight line. This makes the whole field O(r^2)
+	//! to compute, at the cost of rays that may deviate slightly from the straight lines of @p region::occlusion.
+	struct field_of_view {
+		//! Computes the field of view from @p origin out to @p radius in @p region.
+		field_of_view(region const& region, tile_hex_point origin, pace radius);
+
+		//! The point from which this field of view is seen.
+		auto origin() const -> tile_hex_point {
+			return _origin;
+		}
+
+		//! The distance this field of view extends from the origin.
+		auto radius() const -> pace {
+			return _radius;
+		}
+
+		//! The proportion of the view from the origin to @p coords that is blocked, in [0, 1]. Tiles out of range are
+		//! fully occluded.
+		auto occlusion_at(tile_hex_point coords) const -> double;
+
+	private:
+		tile_hex_point _origin;
+		pace _radius;
+
+		//! The occlusion of each tile in the rhomboid bounding this field of view, in q-major order.
+		std::vector<double> _occlusion;
+	};
+}
@@ -22,8 +22,14 @@ namespace ql {
 
 		// Compute light source's luminance at this distance.
 		pace const distance = (target_location.coords - location.coords).length();
-		auto& region = reg->get<ql::region>(id);
+		auto& region = reg->get<ql::region>(location.region_id);
 		double const occlusion = region.occlusion(target_location.coords, location.coords);
-		return std::max(0_lum, luminance - cancel::quantity_cast<lum>(distance * lum_per_pace * occlusion));
+		return luminance_at(distance, occlusion);
+	}
+
+	auto light_source::luminance_at(pace distance, double occlusion) const -> lum {
+		// Light falls off linearly with distance, and occluders block a proportion of what remains.
+		auto const unoccluded = luminance - distance * lum_per_pace;
+		return std::max(0_lum, cancel::quantity_cast<lum>((1.0 - occlusion) * unoccluded));
 	}
 }
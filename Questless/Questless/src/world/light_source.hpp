@@ -21,5 +21,8 @@ namespace ql {
 
 		//! How brightly this light source shines at @p target_location.
 		auto luminance_at(location target_location) const -> lum;
+
+		//! How brightly this light source shines at @p distance, through a line of sight with the given @p occlusion.
+		auto luminance_at(pace distance, double occlusion) const -> lum;
 	};
 }
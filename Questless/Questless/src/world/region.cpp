@@ -2,21 +2,30 @@
 //! @copyright See <a href="LICENSE.txt">LICENSE.txt</a>.
 
 #include "region.hpp"
+#include "field_of_view.hpp"
 #include "light_source.hpp"
+#include "section_streamer.hpp"
 #include "tile.hpp"
 
 #include "agents/agent.hpp"
 #include "agents/basic_ai.hpp"
 #include "agents/lazy_ai.hpp"
 #include "effects/effect.hpp"
+#include "entities/beings/body.hpp"
 #include "entities/beings/human.hpp"
 #include "entities/objects/campfire.hpp"
 #include "items/weapons/quarterstaff.hpp"
 #include "utility/random.hpp"
 #include "utility/utility.hpp"
 
+#include <algorithm>
+#include <array>
 #include <climits>
+#include <execution>
+#include <map>
+#include <numeric>
 #include <optional>
+#include <vector>
 
 namespace ql {
 	namespace {
@@ -28,60 +37,58 @@ namespace ql {
 		constexpr tick end_of_dusk = 55 * day_length / 100;
 		constexpr tick end_of_evening = 67 * day_length / 100;
 		constexpr tick end_of_night = 95 * day_length / 100;
+
+		//! Performs @p f on the coordinates of each section, loaded or not, that overlaps the rhombus of tiles within
+		//! @p range of @p origin along each axis, which contains every tile within @p range of @p origin.
+		template <typename F>
+		auto for_each_section_overlapping(tile_hex_point origin, pace range, F&& f) -> void {
+			auto const min_coords = section::containing_section_coords(origin - tile_hex_vector{range, range});
+			auto const max_coords = section::containing_section_coords(origin + tile_hex_vector{range, range});
+			for (section_span q = min_coords.q; q <= max_coords.q; ++q) {
+				for (section_span r = min_coords.r; r <= max_coords.r; ++r) {
+					f(section_hex_point{q, r});
+				}
+			}
+		}
 	}
 
-	region::region(ql::reg& reg, ql::id id, std::string region_name)
+	region::region(ql::reg& reg, ql::id id, std::string region_name, std::uint64_t world_seed)
 		: reg{&reg}
 		, id{id}
 		, name{std::move(region_name)}
+		, _key{combine_keys(world_seed, string_key(name))}
 		, _time{0}
 		, _time_of_day{get_time_of_day()}
 		, _period_of_day{get_period_of_day()}
-		, _ambient_illuminance{get_ambient_illuminance()} //
+		, _ambient_illuminance{get_ambient_illuminance()}
+		, _turns{reg}
+		, _next_thaw_time{0} //
 	{
-		auto const r_radius = 1_section_span;
-		auto const q_radius = 1_section_span;
-
-		for (section_span section_r = -r_radius; section_r <= r_radius; ++section_r) {
-			for (section_span section_q = -q_radius; section_q <= q_radius; ++section_q) {
-				section_hex_point section_coords{section_q, section_r};
-
-				// Generate a new random section.
-				section& section =
-					_section_map.insert(std::make_pair(section_coords, ql::section{reg, id, section_coords})).first->second;
-
-				// Add beings randomly.
-				auto const section_center = section.center_coords();
-				for (pace q = -section_radius; q <= section_radius; ++q) {
-					for (pace r = -section_radius; r <= section_radius; ++r) {
-						if ((section_r != 0_section_span || section_q != 0_section_span) && uniform(0, 10) == 0) {
-							auto const entity_coords = section_center + tile_hex_vector{q, r};
-							if (!uniform(0, 12)) {
-								// Create and spawn campfire.
-								auto const campfire_id = reg.create();
-								make_campfire(reg, campfire_id, location{id, entity_coords});
-								bool const success = try_add(campfire_id, entity_coords);
-								assert(success);
-							} else {
-								// Create human.
-								auto const human_id = reg.create();
-								make_human(reg, human_id, location{id, entity_coords}, {basic_ai{reg, human_id}});
-								// Create quarterstaff.
-								auto const quarterstaff_id = reg.create();
-								make_quarterstaff(reg, quarterstaff_id);
-								// Give quarterstaff to human.
-								reg.get<inventory>(human_id).add(quarterstaff_id);
-								// Spawn human.
-								bool const success = try_add(std::move(human_id), entity_coords);
-								assert(success);
-							}
-						}
-					}
-				}
+		// Generate the sections around the origin synchronously so the region is immediately playable. Sections further
+		// out are streamed in as anchors approach them.
+		auto const radius = section_anchor{}.radius;
+		std::vector<section_hex_point> initial_coords;
+		for (section_span section_r = -radius; section_r <= radius; ++section_r) {
+			for (section_span section_q = -radius; section_q <= radius; ++section_q) {
+				initial_coords.push_back({section_q, section_r});
 			}
 		}
+		for (auto const& blueprint : generate_section_blueprints(_key, initial_coords)) {
+			install(blueprint);
+		}
+
+		_streamer = umake<section_streamer>(name, _key);
+
+		// Light up the initial sections.
+		update_light_map();
 	}
 
+	region::region(region&&) noexcept = default;
+
+	region::~region() = default;
+
+	auto region::operator=(region&&) noexcept -> region& = default;
+
 	auto region::entity_id_at(tile_hex_point tile_coords) const -> std::optional<ql::id> {
 		if (auto section = containing_section(tile_coords)) {
 			return section->entity_id_at(tile_coords);
@@ -90,6 +97,29 @@ namespace ql {
 		}
 	}
 
+	auto region::nearest_entities(tile_hex_point origin, std::size_t k, pace max_radius) const -> std::vector<ql::id> {
+		// Widen the search until it finds at least k entities. The k nearest are then certainly among those found.
+		std::vector<std::pair<pace, ql::id>> found;
+		for (pace radius = std::min(1_pace, max_radius);; radius = std::min(2 * radius, max_radius)) {
+			found.clear();
+			for_each_entity_within(origin, radius, [&](tile_hex_point coords, ql::id entity_id) {
+				found.emplace_back((coords - origin).length(), entity_id);
+			});
+			if (found.size() >= k || radius >= max_radius) { break; }
+		}
+
+		auto const count = std::min(k, found.size());
+		std::partial_sort(found.begin(), found.begin() + count, found.end(), [](auto const& a, auto const& b) {
+			return a.first < b.first;
+		});
+		std::vector<ql::id> result;
+		result.reserve(count);
+		for (std::size_t i = 0; i < count; ++i) {
+			result.push_back(found[i].second);
+		}
+		return result;
+	}
+
 	auto region::get_spawn_location() -> location {
 		//! @todo More advanced spawning.
 
@@ -99,8 +129,8 @@ namespace ql {
 		// Destroy and remove the entity currently there, if any.
 		if (auto const o_entity_id = entity_id_at(player_coords)) {
 			auto const entity_id = *o_entity_id;
-			reg->destroy(entity_id);
 			remove(entity_id);
+			reg->destroy(entity_id);
 		}
 
 		// Return the now guaranteed-empty location.
@@ -111,7 +141,12 @@ namespace ql {
 		if (auto section = containing_section(tile_coords)) {
 			reg->get<location>(entity_id) = {id, tile_coords};
 
-			return section->try_add(entity_id);
+			if (!section->try_add(entity_id)) { return false; }
+			invalidate_lights_reaching(tile_coords);
+			invalidate_light_source(entity_id);
+			// New agents take their first turn right away.
+			if (reg->has<agent>(entity_id) && !reg->has<turn_schedule>(entity_id)) { schedule_turn(entity_id, 0_tick); }
+			return true;
 		} else {
 			//! @todo What to do when adding outside current sections?
 			return false;
@@ -125,57 +160,77 @@ namespace ql {
 			return false;
 		}
 
-		section& src_section = *containing_section(location.coords);
-		section* dst_section = containing_section(tile_coords);
-		if (dst_section != &src_section) {
-			if (dst_section != nullptr) {
-				if (dst_section->entity_id_at(tile_coords)) {
-					// Collision with another entity. Prevent movement.
-					return false;
-				}
-
-				src_section.remove(entity_id);
-				location.coords = tile_coords;
-				return dst_section->try_add(entity_id);
-			} else {
-				//! @todo Need to deal with null destination case.
+		section* src_section = containing_section(location.coords);
+		if (src_section == nullptr) {
+			// The entity's section has been evicted.
+			return false;
+		}
+		auto const src_coords = location.coords;
+		if (src_section->contains(tile_coords)) {
+			// Move within the section in place.
+			if (!src_section->try_move(entity_id, tile_coords)) {
+				// Collision with another entity. Prevent movement.
 				return false;
 			}
+			location.coords = tile_coords;
 		} else {
-			if (src_section.entity_id_at(tile_coords)) {
+			section* dst_section = containing_section(tile_coords);
+			if (dst_section == nullptr) {
+				// The destination section is not loaded yet.
+				return false;
+			}
+			if (dst_section->entity_id_at(tile_coords)) {
 				// Collision with another entity. Prevent movement.
 				return false;
 			}
-			src_section.remove(entity_id);
+			src_section->remove(entity_id);
 			location.coords = tile_coords;
-			return src_section.try_add(entity_id);
+			if (!dst_section->try_add(entity_id)) { return false; }
 		}
+
+		// The entity no longer occludes light at its source and now occludes it at its destination.
+		invalidate_lights_reaching(src_coords);
+		invalidate_lights_reaching(tile_coords);
+		invalidate_light_source(entity_id);
+		return true;
 	}
 
 	auto region::remove(ql::id entity_id) -> void {
 		auto& location = reg->get<ql::location>(entity_id);
-		if (auto section = containing_section(location.coords)) { section->remove(entity_id); }
+		if (auto section = containing_section(location.coords)) {
+			section->remove(entity_id);
+			invalidate_lights_reaching(location.coords);
+			invalidate_light_source(entity_id);
+		}
 	}
 
-	auto region::tile_id_at(tile_hex_point tile_coords) const -> std::optional<ql::id> {
+	auto region::tile_at(tile_hex_point tile_coords) const -> std::optional<tile_ref> {
 		if (auto section = containing_section(tile_coords)) {
-			return section->tile_id_at(tile_coords);
+			return section->tile_at(tile_coords);
 		} else {
 			return std::nullopt;
 		}
 	}
 
+	auto region::ground_items_at(tile_hex_point tile_coords) -> inventory* {
+		if (auto section = containing_section(tile_coords)) {
+			return &section->ground_items(section->tile_index(tile_coords));
+		} else {
+			return nullptr;
+		}
+	}
+
 	auto region::illuminance(tile_hex_point tile_coords) const -> lum {
-		if (auto tile_id = tile_id_at(tile_coords)) {
-			return _ambient_illuminance + reg->get<lum>(*tile_id);
+		if (auto tile = tile_at(tile_coords)) {
+			return _ambient_illuminance + tile->luminance() + tile->light();
 		} else {
 			return _ambient_illuminance;
 		}
 	}
 
 	auto region::temperature(tile_hex_point tile_coords) const -> ql::temperature {
-		if (auto tile_id = tile_id_at(tile_coords)) {
-			return reg->get<ql::temperature>(*tile_id);
+		if (auto tile = tile_at(tile_coords)) {
+			return tile->temperature();
 		} else {
 			return 0_temp;
 		}
@@ -183,10 +238,11 @@ namespace ql {
 
 	auto region::occlusion(tile_hex_point start, tile_hex_point end) const -> double {
 		auto line = start.line_to(end);
+		auto cursor = this->cursor();
 		double transparency = 1.0;
 		for (std::size_t i = 1; i < line.size() - 1; ++i) {
 			//! @todo Handle transparency/occlusion in a more sensible way.
-			if (entity_id_at(line[i])) { transparency *= 0.5; }
+			if (cursor.entity_id_at(line[i])) { transparency *= 0.5; }
 		}
 		return 1.0 - transparency;
 	}
@@ -197,32 +253,375 @@ namespace ql {
 		_period_of_day = get_period_of_day();
 
 		_ambient_illuminance = get_ambient_illuminance();
+
+		stream_sections();
+		update_light_map();
+
+		if (_time >= _next_thaw_time) {
+			thaw_beings();
+			_next_thaw_time = _time + lod.mid_period;
+		}
+	}
+
+	auto region::schedule_turn(ql::id being_id, tick delay) -> void {
+		switch (lod_tier_at(reg->get<location>(being_id).coords)) {
+			case lod_tier::near:
+				reg->reset<frozen>(being_id);
+				_turns.schedule(being_id, _time + delay);
+				break;
+			case lod_tier::mid:
+				reg->reset<frozen>(being_id);
+				_turns.schedule(being_id, _time + std::max(delay, lod.mid_period));
+				break;
+			case lod_tier::far:
+				// The scheduler drops frozen beings, but their ready times are kept for when they're thawed. Their
+				// bodies aren't updated in the meantime, so they catch up on the whole gap when they next act.
+				_turns.schedule(being_id, _time + delay);
+				if (!reg->has<frozen>(being_id)) { reg->assign<frozen>(being_id); }
+				break;
+		}
+	}
+
+	auto region::lod_tier_at(tile_hex_point tile_coords) const -> lod_tier {
+		std::optional<pace> o_min_distance;
+		reg->view<section_anchor, location>().each([&](section_anchor const&, ql::location const& location) {
+			if (location.region_id != id) { return; }
+			auto const distance = (location.coords - tile_coords).length();
+			if (!o_min_distance || distance < *o_min_distance) { o_min_distance = distance; }
+		});
+		return o_min_distance ? lod.tier_at(*o_min_distance) : lod_tier::near;
+	}
+
+	auto region::thaw_beings() -> void {
+		std::vector<ql::id> thawed_ids;
+		for (auto const being_id : reg->view<frozen>()) {
+			// Dormant beings are rescheduled when their sections are reloaded.
+			if (reg->has<dormant>(being_id)) { continue; }
+			if (lod_tier_at(reg->get<location>(being_id).coords) != lod_tier::far) { thawed_ids.push_back(being_id); }
+		}
+		for (auto const being_id : thawed_ids) {
+			// Resume the turn the being was frozen waiting for.
+			auto const ready_time = reg->get<turn_schedule>(being_id).ready_time;
+			schedule_turn(being_id, std::max(ready_time - _time, 0_tick));
+		}
+	}
+
+	auto region::pop_ready_beings() -> std::vector<ql::id> {
+		std::vector<ql::id> result;
+		while (auto const o_being_id = _turns.pop_ready(_time)) {
+			result.push_back(*o_being_id);
+		}
+
+		// Catch the bodies up on the time since their beings last acted, starting with drifting their conditions all at
+		// once.
+		_cond_batch.clear();
+		for (auto const being_id : result) {
+			_cond_batch.push_back(reg->get<body>(being_id).cond, _time - reg->get<turn_schedule>(being_id).last_update);
+		}
+		_cond_batch.advance();
+
+		// Each body update only touches its own body and parts, so bodies can be updated in parallel. Anything that
+		// affects other entities, such as injuries, is deferred until all bodies are done. Each being's conditions are
+		// at its index in the batch.
+		std::vector<std::size_t> indices(result.size());
+		std::iota(indices.begin(), indices.end(), std::size_t{0});
+		std::for_each(std::execution::par, indices.begin(), indices.end(), [this, &result](std::size_t idx) {
+			auto const being_id = result[idx];
+			auto& schedule = reg->get<turn_schedule>(being_id);
+			auto& body = reg->get<ql::body>(being_id);
+			_cond_batch.store(idx, body.cond);
+			body.update_drifted(_time - schedule.last_update, _cond_batch.thresholds(idx));
+			schedule.last_update = _time;
+		});
+		return result;
+	}
+
+	auto region::add_effect(ql::id emitter_id, effects::effect effect) -> void {
+		_effects.push(emitter_id, std::move(effect));
+	}
+
+	auto region::deliver_effects() -> void {
+		auto const effects = _effects.take();
+		if (effects.empty()) { return; }
+
+		// Batch the effects by each loaded section overlapping their ranges, keeping their order within each batch.
+		std::map<section_hex_point, std::vector<effects::effect const*>> batches;
+		for (auto const& effect : effects) {
+			for_each_section_overlapping(effect.origin(), effect.range(), [&](section_hex_point section_coords) {
+				if (_sections.find(section_coords) != nullptr) { batches[section_coords].push_back(&effect); }
+			});
+		}
+
+		// Each agent perceives the effects in its section's batch that are within range of it.
+		for (auto const& [section_coords, batch] : batches) {
+			_sections.find(section_coords)->for_each_occupant([&](tile_hex_point coords, ql::id entity_id) {
+				agent* const agent = reg->try_get<ql::agent>(entity_id);
+				if (agent == nullptr) { return; }
+				for (auto const effect : batch) {
+					if ((coords - effect->origin()).length() <= effect->range()) { agent->perceive(*effect); }
+				}
+			});
+		}
+	}
+
+	auto region::install(section_blueprint const& blueprint) -> void {
+		// The new section's light map starts dark. Take back the light of any source that could reach it before the
+		// section is loaded, so that the light is propagated into the new section along with everywhere else.
+		if (auto it = _lights_by_section.find(blueprint.coords); it != _lights_by_section.end()) {
+			// Removing the footprints updates the index, so work from a copy.
+			auto const light_ids = it->second;
+			for (auto const light_id : light_ids) {
+				remove_light_footprint(light_id);
+				_dirty_lights.insert(light_id);
+			}
+		}
+
+		auto& section = _sections.insert(umake<ql::section>(*reg, blueprint));
+
+		// Wake up entities that were in the section when it was evicted.
+		for (auto const occupant_id : blueprint.occupant_ids) {
+			if (!reg->valid(occupant_id)) { continue; }
+			reg->reset<dormant>(occupant_id);
+			bool const success = section.try_add(occupant_id);
+			assert(success);
+			invalidate_light_source(occupant_id);
+			if (auto schedule = reg->try_get<turn_schedule>(occupant_id)) {
+				// Dormant beings aren't simulated, so their bodies resume from now.
+				schedule->last_update = _time;
+				schedule_turn(occupant_id, 0_tick);
+			}
+		}
+
+		// Create the entities of a newly generated section.
+		for (auto const& spawn : blueprint.spawns) {
+			switch (spawn.kind) {
+				case section_blueprint::spawn::entity_kind::campfire: {
+					// Create and spawn campfire.
+					auto const campfire_id = reg->create();
+					make_campfire(*reg, campfire_id, location{id, spawn.coords});
+					bool const success = try_add(campfire_id, spawn.coords);
+					assert(success);
+					break;
+				}
+				case section_blueprint::spawn::entity_kind::human: {
+					// Create human.
+					auto const human_id = reg->create();
+					make_human(*reg, human_id, location{id, spawn.coords}, {basic_ai{*reg, human_id}});
+					// Create quarterstaff.
+					auto const quarterstaff_id = reg->create();
+					make_quarterstaff(*reg, quarterstaff_id);
+					// Give quarterstaff to human.
+					reg->get<inventory>(human_id).add(quarterstaff_id);
+					// Spawn human.
+					bool const success = try_add(human_id, spawn.coords);
+					assert(success);
+					break;
+				}
+				default:
+					UNREACHABLE;
+			}
+		}
+	}
+
+	auto region::evict(section_hex_point coords) -> void {
+		auto section = _sections.extract(coords);
+		auto blueprint = section->save();
+		// The section's occupants no longer occlude the light of sources that reach into it.
+		if (auto it = _lights_by_section.find(coords); it != _lights_by_section.end()) {
+			_dirty_lights.insert(it->second.begin(), it->second.end());
+		}
+		// Occupants stay in the registry but are not simulated while their section is unloaded.
+		for (auto const occupant_id : blueprint.occupant_ids) {
+			reg->assign<dormant>(occupant_id);
+			// Dormant light sources don't shine.
+			remove_light_footprint(occupant_id);
+			_dirty_lights.erase(occupant_id);
+		}
+		_streamer->request_store(std::move(blueprint));
+	}
+
+	auto region::invalidate_light_source(ql::id entity_id) -> void {
+		if (_light_footprints.contains(entity_id) || (reg->valid(entity_id) && reg->has<light_source>(entity_id))) {
+			_dirty_lights.insert(entity_id);
+		}
+	}
+
+	auto region::rebuild_light_map() -> void {
+		_sections.for_each([](section& section) { std::ranges::fill(section.light(), 0_lum); });
+		_light_footprints.clear();
+		_lights_by_section.clear();
+		for (auto const light_id : reg->view<light_source, location>()) {
+			if (reg->get<ql::location>(light_id).region_id == id) { _dirty_lights.insert(light_id); }
+		}
+		update_light_map();
+	}
+
+	auto region::invalidate_lights_reaching(tile_hex_point tile_coords) -> void {
+		// Only light sources indexed under the tile's section could reach it.
+		auto const it = _lights_by_section.find(section::containing_section_coords(tile_coords));
+		if (it == _lights_by_section.end()) { return; }
+		for (auto const light_id : it->second) {
+			auto const& footprint = _light_footprints.at(light_id);
+			if ((tile_coords - footprint.origin).length() <= footprint.range) { _dirty_lights.insert(light_id); }
+		}
 	}
 
-	auto region::add_effect(effects::effect const& effect) -> void {
-		// Each agent within range in loaded sections perceives the effect.
-		for_each_loaded_section([&](section& section) {
-			for (auto& [coords, id] : section.entity_id_map()) {
-				if ((coords - effect.origin()).length() <= effect.range()) {
-					if (agent* agent = reg->try_get<ql::agent>(id)) { agent->perceive(effect); }
+	auto region::update_light_map() -> void {
+		for (auto const light_id : _dirty_lights) {
+			// Take back the light's previous contribution.
+			remove_light_footprint(light_id);
+
+			// Propagate the light again if it's still a light source in a loaded part of this region.
+			if (!reg->valid(light_id)) { continue; }
+			auto const light = reg->try_get<light_source>(light_id);
+			if (light == nullptr) { continue; }
+			auto const& location = reg->get<ql::location>(light_id);
+			if (location.region_id != id || entity_id_at(location.coords) != light_id) { continue; }
+
+			light_footprint footprint{location.coords, light->range(), {}};
+			field_of_view const fov{*this, footprint.origin, footprint.range};
+			auto cursor = this->cursor();
+			for (pace q = -footprint.range; q <= footprint.range; ++q) {
+				for (pace r = -footprint.range; r <= footprint.range; ++r) {
+					auto const offset = tile_hex_vector{q, r};
+					auto const distance = offset.length();
+					if (distance > footprint.range) { continue; }
+					auto const tile_coords = footprint.origin + offset;
+					if (cursor.section_at(tile_coords) == nullptr) { continue; }
+					auto const luminance = light->luminance_at(distance, fov.occlusion_at(tile_coords));
+					if (luminance > 0_lum) { footprint.contributions.emplace_back(tile_coords, luminance); }
 				}
 			}
+			add_light_footprint(light_id, std::move(footprint));
+		}
+		_dirty_lights.clear();
+	}
+
+	auto region::apply_light_footprint(light_footprint const& footprint, int sign) -> void {
+		// Consecutive contributions usually fall in the same section.
+		section* current = nullptr;
+		for (auto const& [tile_coords, luminance] : footprint.contributions) {
+			if (current == nullptr || !current->contains(tile_coords)) { current = containing_section(tile_coords); }
+			if (current != nullptr) { current->light()[current->tile_index(tile_coords)] += sign * luminance; }
+		}
+	}
+
+	auto region::add_light_footprint(ql::id light_id, light_footprint footprint) -> void {
+		apply_light_footprint(footprint, 1);
+		for_each_section_overlapping(footprint.origin, footprint.range, [&](section_hex_point section_coords) {
+			_lights_by_section[section_coords].push_back(light_id);
+		});
+		_light_footprints.emplace(light_id, std::move(footprint));
+	}
+
+	auto region::remove_light_footprint(ql::id light_id) -> void {
+		auto const it = _light_footprints.find(light_id);
+		if (it == _light_footprints.end()) { return; }
+		auto const& footprint = it->second;
+		apply_light_footprint(footprint, -1);
+		for_each_section_overlapping(footprint.origin, footprint.range, [&](section_hex_point section_coords) {
+			auto const lights_it = _lights_by_section.find(section_coords);
+			auto& light_ids = lights_it->second;
+			light_ids.erase(std::find(light_ids.begin(), light_ids.end(), light_id));
+			if (light_ids.empty()) { _lights_by_section.erase(lights_it); }
+		});
+		_light_footprints.erase(it);
+	}
+
+	auto region::stream_sections() -> void {
+		// Find the sections each anchor in this region wants loaded and the wider set it wants kept.
+		std::set<section_hex_point> wanted;
+		std::set<section_hex_point> kept;
+		reg->view<section_anchor, location>().each([&](section_anchor const& anchor, ql::location const& location) {
+			if (location.region_id != id) { return; }
+			auto const center = section::containing_section_coords(location.coords);
+			auto const keep_radius = anchor.radius + eviction_margin;
+			for (section_span dq = -keep_radius; dq <= keep_radius; ++dq) {
+				for (section_span dr = -keep_radius; dr <= keep_radius; ++dr) {
+					auto const coords = center + section_hex_vector{dq, dr};
+					kept.insert(coords);
+					if (-anchor.radius <= dq && dq <= anchor.radius && -anchor.radius <= dr && dr <= anchor.radius) {
+						wanted.insert(coords);
+					}
+				}
+			}
+		});
+		// With no anchors in the region, leave it as it is.
+		if (kept.empty()) { return; }
+
+		// Install sections that are due, in order by coordinates, waiting on the streamer for any it hasn't finished.
+		auto const receive = [this](std::vector<section_blueprint> blueprints) {
+			for (auto& blueprint : blueprints) {
+				auto const coords = blueprint.coords;
+				_streamed_blueprints.insert_or_assign(coords, std::move(blueprint));
+			}
+		};
+		receive(_streamer->poll());
+		for (auto it = _pending_sections.begin(); it != _pending_sections.end();) {
+			auto const [coords, due_time] = *it;
+			if (due_time > _time) {
+				++it;
+				continue;
+			}
+			auto streamed = _streamed_blueprints.find(coords);
+			while (streamed == _streamed_blueprints.end()) {
+				receive(_streamer->wait());
+				streamed = _streamed_blueprints.find(coords);
+			}
+			if (_sections.find(coords) == nullptr) { install(streamed->second); }
+			_streamed_blueprints.erase(streamed);
+			it = _pending_sections.erase(it);
+		}
+
+		// Request wanted sections that are neither loaded nor already on their way.
+		for (auto const coords : wanted) {
+			if (_sections.find(coords) == nullptr && !_pending_sections.contains(coords)) {
+				_pending_sections.emplace(coords, _time + section_install_delay);
+				_streamer->request_load(coords);
+			}
+		}
+
+		// Evict sections that no anchor is near anymore.
+		std::vector<section_hex_point> evicted;
+		_sections.for_each([&](section const& section) {
+			auto const coords = section.section_coords();
+			if (!kept.contains(coords)) { evicted.push_back(coords); }
 		});
+		for (auto const coords : evicted) {
+			evict(coords);
+		}
 	}
 
 	auto region::containing_section(tile_hex_point tile_coords) -> section* {
-		auto const q = tile_coords.q >= 0_pace //
-			? 1_section_span * (tile_coords.q + section_radius) / section_diameter
-			: 1_section_span * (tile_coords.q - section_radius) / section_diameter;
-		auto const r = tile_coords.r >= 0_pace //
-			? 1_section_span * (tile_coords.r + section_radius) / section_diameter
-			: 1_section_span * (tile_coords.r - section_radius) / section_diameter;
-		auto it = _section_map.find(section_hex_point{q, r});
-		return it == _section_map.end() ? nullptr : &it->second;
+		return _sections.find(section::containing_section_coords(tile_coords));
 	}
 
 	auto region::containing_section(tile_hex_point tile_coords) const -> section const* {
-		return const_cast<region&>(*this).containing_section(tile_coords);
+		return _sections.find(section::containing_section_coords(tile_coords));
+	}
+
+	auto region::section_cursor::section_at(tile_hex_point tile_coords) -> section const* {
+		// Only consult the section directory when leaving the cached section.
+		if (_section == nullptr || !_section->contains(tile_coords)) {
+			_section = _region->containing_section(tile_coords);
+		}
+		return _section;
+	}
+
+	auto region::section_cursor::entity_id_at(tile_hex_point tile_coords) -> std::optional<ql::id> {
+		if (auto section = section_at(tile_coords)) {
+			return section->entity_id_at(tile_coords);
+		} else {
+			return std::nullopt;
+		}
+	}
+
+	auto region::section_cursor::tile_at(tile_hex_point tile_coords) -> std::optional<tile_ref> {
+		if (auto section = section_at(tile_coords)) {
+			return section->tile_at(tile_coords);
+		} else {
+			return std::nullopt;
+		}
 	}
 
 	auto region::get_time_of_day() const -> tick {
@@ -275,19 +674,206 @@ namespace ql {
 	}
 
 	auto region::for_each_loaded_section(std::function<void(section&)> const& f) -> void {
-		constexpr auto loaded_sections_q_radius = 1_section_span;
-		constexpr auto loaded_sections_r_radius = 1_section_span;
+		_sections.for_each(f);
+	}
 
-		for (section_span r = -loaded_sections_q_radius; r <= loaded_sections_q_radius; ++r) {
-			for (section_span q = -loaded_sections_r_radius; q <= loaded_sections_r_radius; ++q) {
-				section_hex_point const section_coords{q, r};
-				if (auto it = _section_map.find(section_coords); it != _section_map.end()) { f(it->second); }
+	auto make_region(reg& reg, id region_id, std::string name, std::uint64_t world_seed) -> id {
+		reg.assign<region>(region_id, reg, region_id, std::move(name), world_seed);
+		return region_id;
+	}
+}
+
+#include "doctest_wrapper/test.hpp"
+
+TEST_CASE("[region] entity queries") {
+	using namespace ql;
+
+	reg reg;
+	id const region_id = make_region(reg, reg.create(), "Region 1", 0);
+	auto& region = reg.get<ql::region>(region_id);
+
+	// Scatter plain entities over the loaded sections, in addition to those generated with the region.
+	constexpr int extent = (section_radius + section_diameter).data;
+	keyed_prng prng{string_key("region queries")};
+	for (int i = 0; i < 1000; ++i) {
+		tile_hex_point const coords{pace{prng.uniform(-extent, extent)}, pace{prng.uniform(-extent, extent)}};
+		if (region.entity_id_at(coords)) { continue; }
+		id const entity_id = reg.create();
+		reg.assign<location>(entity_id, location{region_id, coords});
+		REQUIRE(region.try_add(entity_id, coords));
+	}
+
+	// The reference for each query is a scan of every tile.
+	std::vector<std::pair<tile_hex_point, id>> all_entities;
+	for (int q = -extent - 1; q <= extent + 1; ++q) {
+		for (int r = -extent - 1; r <= extent + 1; ++r) {
+			tile_hex_point const coords{pace{q}, pace{r}};
+			if (auto const o_entity_id = region.entity_id_at(coords)) {
+				all_entities.emplace_back(coords, *o_entity_id);
+			}
+		}
+	}
+	REQUIRE_GT(all_entities.size(), 500u);
+	auto const sorted = [](std::vector<id> ids) {
+		std::sort(ids.begin(), ids.end());
+		return ids;
+	};
+	auto const brute_force = [&](auto const& include) {
+		std::vector<id> result;
+		for (auto const& [coords, entity_id] : all_entities) {
+			if (include(coords)) { result.push_back(entity_id); }
+		}
+		return sorted(std::move(result));
+	};
+
+	// Origins at, beside, and between section centers and edges, out to the edges of the loaded sections.
+	std::vector<tile_hex_point> origins;
+	for (int q : {-extent, -21, -11, -10, 0, 10, 11, 20, extent}) {
+		for (int r : {-extent, -21, -11, -10, 0, 10, 11, 20, extent}) {
+			origins.push_back({pace{q}, pace{r}});
+		}
+	}
+	// Radii within one section, spanning several, and reaching past the loaded sections.
+	std::array const radii{0_pace, 1_pace, 3_pace, 10_pace, 11_pace, 21_pace, 40_pace};
+
+	SUBCASE("within a radius") {
+		for (auto const origin : origins) {
+			for (auto const radius : radii) {
+				std::vector<id> found;
+				region.for_each_entity_within(origin, radius, [&](tile_hex_point coords, id entity_id) {
+					CHECK_EQ(region.entity_id_at(coords), entity_id);
+					found.push_back(entity_id);
+				});
+				auto const expected = brute_force([&](tile_hex_point coords) {
+					return (coords - origin).length() <= radius;
+				});
+				CHECK_EQ(sorted(std::move(found)), expected);
 			}
 		}
 	}
+	SUBCASE("in view") {
+		for (auto const origin : origins) {
+			for (auto const radius : radii) {
+				for (int direction_idx = 0; direction_idx < 6; ++direction_idx) {
+					auto const direction = static_cast<hex_direction>(direction_idx);
+					std::vector<id> found;
+					region.for_each_entity_in_view(origin, direction, radius, [&](tile_hex_point, id entity_id) {
+						found.push_back(entity_id);
+					});
+					auto const expected = brute_force([&](tile_hex_point coords) {
+						return (coords - origin).length() <= radius &&
+							inside_field_of_vision(origin, direction, coords);
+					});
+					CHECK_EQ(sorted(std::move(found)), expected);
+				}
+			}
+		}
+	}
+	SUBCASE("nearest") {
+		// Include k past the whole population, and a maximum radius past the farthest loaded tile.
+		std::array const ks{std::size_t{0}, std::size_t{1}, std::size_t{7}, std::size_t{100}, all_entities.size() + 1};
+		std::array const max_radii{0_pace, 5_pace, 21_pace, 4 * extent * 1_pace};
+		for (auto const origin : origins) {
+			for (auto const k : ks) {
+				for (auto const max_radius : max_radii) {
+					auto const nearest = region.nearest_entities(origin, k, max_radius);
+
+					// Ties can be broken either way, so compare distances rather than IDs.
+					std::vector<pace> expected_distances;
+					for (auto const& [coords, entity_id] : all_entities) {
+						auto const distance = (coords - origin).length();
+						if (distance <= max_radius) { expected_distances.push_back(distance); }
+					}
+					std::sort(expected_distances.begin(), expected_distances.end());
+					expected_distances.resize(std::min(k, expected_distances.size()));
 
-	auto make_region(reg& reg, id region_id, std::string name) -> id {
-		reg.assign<region>(region_id, reg, region_id, std::move(name));
-		return region_id;
+					std::vector<pace> distances;
+					for (auto const entity_id : nearest) {
+						distances.push_back((reg.get<location>(entity_id).coords - origin).length());
+					}
+					CHECK_EQ(distances, expected_distances);
+
+					auto const nearest_ids = sorted(nearest);
+					CHECK(std::adjacent_find(nearest_ids.begin(), nearest_ids.end()) == nearest_ids.end());
+				}
+			}
+		}
+	}
+}
+
+
+TEST_CASE("[region] incremental light map matches a rebuilt one") {
+	using namespace ql;
+
+	reg reg;
+	id const region_id = make_region(reg, reg.create(), "Region 1", 0);
+	auto& region = reg.get<ql::region>(region_id);
+	keyed_prng prng{string_key("light map")};
+
+	// Scatter light sources, and plain entities to occlude them, over the loaded sections.
+	constexpr int extent = (section_radius + section_diameter).data;
+	auto const scatter = [&](int count, auto const& make) {
+		std::vector<id> result;
+		while (static_cast<int>(result.size()) < count) {
+			tile_hex_point const coords{pace{prng.uniform(-extent, extent)}, pace{prng.uniform(-extent, extent)}};
+			if (region.entity_id_at(coords)) { continue; }
+			id const entity_id = reg.create();
+			make(entity_id, location{region_id, coords});
+			REQUIRE(region.try_add(entity_id, coords));
+			result.push_back(entity_id);
+		}
+		return result;
+	};
+	auto movers = scatter(30, [&](id entity_id, location entity_location) {
+		make_campfire(reg, entity_id, entity_location);
+	});
+	auto const occluder_ids = scatter(100, [&](id entity_id, location entity_location) {
+		reg.assign<location>(entity_id, entity_location);
+	});
+	movers.insert(movers.end(), occluder_ids.begin(), occluder_ids.end());
+
+	// The light of every loaded tile, in a fixed order.
+	auto const light_map = [&](tile_hex_point center) {
+		constexpr int map_extent = 4 * section_diameter.data;
+		std::vector<lum> result;
+		for (int q = -map_extent; q <= map_extent; ++q) {
+			for (int r = -map_extent; r <= map_extent; ++r) {
+				if (auto const o_tile = region.tile_at(center + tile_hex_vector{pace{q}, pace{r}})) {
+					result.push_back(o_tile->light());
+				}
+			}
+		}
+		return result;
+	};
+
+	// Move an anchor away from the origin a couple of sections at a time, so that sections are installed ahead of it
+	// and evicted behind it, while the light sources and occluders wander.
+	id const anchor_id = reg.create();
+	reg.assign<location>(anchor_id, location{region_id, tile_hex_point{0_pace, 0_pace}});
+	reg.assign<section_anchor>(anchor_id);
+	constexpr std::array<std::array<int, 2>, 4> anchor_sections{{{0, 0}, {2, 0}, {4, 0}, {4, 2}}};
+	for (auto const [section_q, section_r] : anchor_sections) {
+		tile_hex_point const anchor_coords{section_q * section_diameter, section_r * section_diameter};
+		reg.get<location>(anchor_id).coords = anchor_coords;
+		for (int tick = 1; tick <= 40; ++tick) {
+			for (int i = 0; i < 10; ++i) {
+				auto const mover_idx = prng.uniform(0, static_cast<int>(movers.size()) - 1);
+				id const mover_id = movers[static_cast<std::size_t>(mover_idx)];
+				auto const direction = static_cast<hex_direction>(prng.uniform(0, 5));
+				// Fails harmlessly if the mover is dormant or blocked.
+				[[maybe_unused]] bool const moved =
+					region.try_move(mover_id, reg.get<location>(mover_id).coords.neighbor(direction));
+			}
+			region.update(1_tick);
+			if (tick % 10 == 0) {
+				auto const incremental = light_map(anchor_coords);
+				region.rebuild_light_map();
+				CHECK(incremental == light_map(anchor_coords));
+			}
+		}
 	}
+
+	// The anchor ended far enough from the origin for the sections there to have been evicted.
+	CHECK_FALSE(region.tile_at(tile_hex_point{0_pace, 0_pace}));
+	CHECK(region.tile_at(tile_hex_point{4 * section_diameter, 2 * section_diameter}));
 }
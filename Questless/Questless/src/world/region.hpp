@@ -3,23 +3,44 @@
 
 #pragma once
 
+#include "field_of_view.hpp"
 #include "section.hpp"
+#include "section_grid.hpp"
+#include "simulation_lod.hpp"
 
+#include "agents/turn_scheduler.hpp"
+#include "effects/effect_queue.hpp"
+#include "entities/beings/body_cond_batch.hpp"
 #include "quantities/misc.hpp"
 
+#include <cstdint>
 #include <functional>
 #include <map>
 #include <memory>
 #include <set>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
 namespace ql {
-	namespace effects {
-		struct effect;
-	}
+	struct section_streamer;
 
 	enum class period_of_day { morning, afternoon, dusk, evening, night, dawn };
 
+	//! Marks an entity around which its region keeps sections loaded.
+	struct section_anchor {
+		//! How many sections in each direction from the anchor's section to keep loaded.
+		section_span radius = 1_section_span;
+	};
+
+	//! Tags an entity whose section has been evicted. Dormant entities are not simulated until their section is loaded.
+	struct dormant {};
+
+	//! Tags a being too far from any observer to be simulated. Frozen beings are woken when an observer comes near.
+	struct frozen {};
+
 	//! A large set of connected sections of hexagonal tiles.
 	struct region {
 		reg_ptr reg;
@@ -29,12 +50,49 @@ namespace ql {
 		//! The player-visible name of the region.
 		std::string name;
 
+		//! How closely beings in this region are simulated by their distance from its section anchors. With no anchors
+		//! in the region, all beings are fully simulated.
+		simulation_lod lod;
+
 		//! Pseudo-randomly generates a new region.
-		region(ql::reg& reg, ql::id id, std::string region_name);
+		//! @param world_seed The seed of the world containing this region. The same seed and name always produce the
+		//! same region.
+		region(ql::reg& reg, ql::id id, std::string region_name, std::uint64_t world_seed);
+
+		region(region&&) noexcept;
+
+		~region();
+
+		auto operator=(region&&) noexcept -> region&;
 
 		//! The ID of the entity at @p tile_coords or nullopt if none.
 		auto entity_id_at(tile_hex_point tile_coords) const -> std::optional<ql::id>;
 
+		//! Calls @p f with the coordinates and ID of each entity in a loaded section within @p radius of @p origin.
+		//! @note Only visits sections overlapping the query hexagon, and only the rows of tiles within it.
+		template <typename F>
+		auto for_each_entity_within(tile_hex_point origin, pace radius, F&& f) const -> void {
+			auto const min_coords = section::containing_section_coords(origin - tile_hex_vector{radius, radius});
+			auto const max_coords = section::containing_section_coords(origin + tile_hex_vector{radius, radius});
+			for (section_span q = min_coords.q; q <= max_coords.q; ++q) {
+				for (section_span r = min_coords.r; r <= max_coords.r; ++r) {
+					if (auto section = _sections.find({q, r})) { section->for_each_occupant_within(origin, radius, f); }
+				}
+			}
+		}
+
+		//! Calls @p f with the coordinates and ID of each entity in a loaded section within @p radius of @p origin and
+		//! inside the field of vision facing @p direction from @p origin.
+		template <typename F>
+		auto for_each_entity_in_view(tile_hex_point origin, hex_direction direction, pace radius, F&& f) const -> void {
+			for_each_entity_within(origin, radius, [&](tile_hex_point coords, ql::id entity_id) {
+				if (inside_field_of_vision(origin, direction, coords)) { f(coords, entity_id); }
+			});
+		}
+
+		//! The IDs of up to @p k entities nearest to @p origin and no farther than @p max_radius, nearest first.
+		auto nearest_entities(tile_hex_point origin, std::size_t k, pace max_radius) const -> std::vector<ql::id>;
+
 		//! Finds a suitable spawn location.
 		auto get_spawn_location() -> location;
 
@@ -49,7 +107,21 @@ namespace ql {
 		auto remove(ql::id entity_id) -> void;
 
 		//! The tile at @p tile_coords or nullopt if none.
-		auto tile_id_at(tile_hex_point tile_coords) const -> std::optional<ql::id>;
+		auto tile_at(tile_hex_point tile_coords) const -> std::optional<tile_ref>;
+
+		//! The items lying on the tile at @p tile_coords, or null if the tile is not loaded.
+		auto ground_items_at(tile_hex_point tile_coords) -> inventory*;
+
+		//! Calls @p f with the coordinates and ID of each item on the ground in a loaded section, in unspecified order.
+		template <typename F>
+		auto for_each_ground_item(F&& f) const -> void {
+			_sections.for_each([&](section const& section) { section.for_each_ground_item(f); });
+		}
+
+		//! The key from which this region's generation is derived.
+		auto key() const -> std::uint64_t {
+			return _key;
+		}
 
 		//! The total in-game time in this region.
 		auto time() const -> tick {
@@ -66,32 +138,127 @@ namespace ql {
 			return _period_of_day;
 		}
 
-		//! The illuminance of the tile at @p tile_coords.
+		//! The illuminance of the tile at @p tile_coords: ambient light, plus the tile's own luminance, plus light from
+		//! light sources as of the last update.
 		auto illuminance(tile_hex_point tile_coords) const -> lum;
 
+		//! Schedules the light from @p entity_id to be propagated again at the next update, if it's a light source.
+		//! Moving entities within the region does this automatically; call it after changing a light source directly.
+		auto invalidate_light_source(ql::id entity_id) -> void;
+
+		//! Recomputes the light map from scratch, propagating every light source in the loaded sections again. The
+		//! light map is kept up to date incrementally, so this is only needed to check those updates.
+		auto rebuild_light_map() -> void;
+
 		//! The temperature of the tile at @p tile_coords.
 		auto temperature(tile_hex_point tile_coords) const -> ql::temperature;
 
 		//! The proportion of light/vision occluded between @p start and @p end, as a number in [0, 1].
 		auto occlusion(tile_hex_point start, tile_hex_point end) const -> double;
 
-		//! Advances this region by @elapsed time.
+		//! Schedules the next turn of the being @p being_id to begin @p delay from now, or later or not at all
+		//! depending on its LOD tier. Agents are scheduled to act immediately when they're added to the region and when
+		//! their sections are reloaded.
+		auto schedule_turn(ql::id being_id, tick delay) -> void;
+
+		//! Removes and returns the IDs of all active beings whose turns have come, in turn order. Their bodies are
+		//! first brought up to date in parallel. Any effects that emits are queued for the next delivery.
+		auto pop_ready_beings() -> std::vector<ql::id>;
+
+		//! Advances this region by @elapsed time, streaming sections in and out around section anchors.
 		auto update(tick elapsed) -> void;
 
-		//! Adds an effect to this region, notifying beings within range of its occurrence.
-		//! @param effect The effect to add.
-		auto add_effect(effects::effect const& effect) -> void;
+		//! Adds @p effect, emitted by the entity @p emitter_id, to this region. Beings within range perceive it at the
+		//! next call to @p deliver_effects. Safe to call concurrently, such as from parallel body updates.
+		auto add_effect(ql::id emitter_id, effects::effect effect) -> void;
+
+		//! Notifies agents of the effects added since the last delivery that are within range of them. Effects are
+		//! taken in order by emitter, so that the order is deterministic, and batched by the loaded sections they can
+		//! reach, so that each section's agents are visited once per delivery rather than once per effect. Effects
+		//! added while agents perceive are left for the next delivery.
+		auto deliver_effects() -> void;
+
+		//! Caches the section last visited while walking tiles of a region, so that runs of lookups within the same
+		//! section skip the section directory.
+		//! @note A cursor is invalidated by any change to the set of sections in its region.
+		struct section_cursor {
+			section_cursor(region const& region) : _region{&region} {}
+
+			//! The section containing @p tile_coords or nullptr if none.
+			auto section_at(tile_hex_point tile_coords) -> section const*;
+
+			//! The ID of the entity at @p tile_coords or nullopt if none.
+			auto entity_id_at(tile_hex_point tile_coords) -> std::optional<ql::id>;
+
+			//! The tile at @p tile_coords or nullopt if none.
+			auto tile_at(tile_hex_point tile_coords) -> std::optional<tile_ref>;
+
+		private:
+			region const* _region;
+			section const* _section = nullptr;
+		};
+
+		//! A cursor for walking the tiles of this region.
+		auto cursor() const -> section_cursor {
+			return section_cursor{*this};
+		}
 
 	private:
-		std::map<section_hex_point, section> _section_map;
+		//! Sections are kept loaded this many sections past an anchor's radius, to avoid thrashing at the boundary.
+		static constexpr auto eviction_margin = 1_section_span;
+
+		//! The key from which the generation of each of this region's sections is derived.
+		std::uint64_t _key;
+
+		section_grid _sections;
 		section_hex_point center_section_coords{0_section_span, 0_section_span};
 
+		uptr<section_streamer> _streamer;
+
+		//! Sections are installed this long after they're requested, waiting for the streamer if it hasn't finished by
+		//! then, so that what happens in the region doesn't depend on how fast the streamer runs.
+		static constexpr auto section_install_delay = 10_tick;
+
+		//! Coordinates of sections requested from the streamer but not yet installed, with the times they're due.
+		std::map<section_hex_point, tick> _pending_sections;
+
+		//! Blueprints received from the streamer that aren't due to be installed yet.
+		std::map<section_hex_point, section_blueprint> _streamed_blueprints;
+
 		tick _time;
 		tick _time_of_day;
 		ql::period_of_day _period_of_day;
 
 		lum _ambient_illuminance;
 
+		turn_scheduler _turns;
+
+		//! When frozen beings are next checked for return to range.
+		tick _next_thaw_time;
+
+		//! Effects awaiting delivery.
+		effects::effect_queue _effects;
+
+		//! Drifts the conditions of the beings taking turns, reused across ticks to keep its storage.
+		body_cond_batch _cond_batch;
+
+		//! The light a light source is currently contributing to the light map.
+		struct light_footprint {
+			tile_hex_point origin;
+			pace range;
+			std::vector<std::pair<tile_hex_point, lum>> contributions;
+		};
+
+		//! The footprint of each light source propagated into the light map, by light source ID.
+		std::unordered_map<ql::id, light_footprint> _light_footprints;
+
+		//! The IDs of the light sources with footprints whose range overlaps each section, loaded or not, so that a
+		//! change in a section only checks the light sources that could reach it.
+		std::map<section_hex_point, std::vector<ql::id>> _lights_by_section;
+
+		//! Light sources whose footprints need to be recomputed.
+		std::unordered_set<ql::id> _dirty_lights;
+
 		//! The section that contains @p tile_coords or nullptr if none.
 		auto containing_section(tile_hex_point tile_coords) -> section*;
 
@@ -103,10 +270,40 @@ namespace ql {
 
 		auto get_ambient_illuminance() -> lum;
 
-		//! Performs some operation on each section in the loaded rhomboid of sections.
+		//! Builds a section from @p blueprint and adds it to this region, along with its occupants and spawns.
+		auto install(section_blueprint const& blueprint) -> void;
+
+		//! Stores the section at @p coords to the section cache and unloads it, making its occupants dormant.
+		auto evict(section_hex_point coords) -> void;
+
+		//! Requests sections that anchors have come near, installs finished ones, and evicts those left behind.
+		auto stream_sections() -> void;
+
+		//! The LOD tier of a being at @p tile_coords, by its distance from the nearest section anchor in this region.
+		auto lod_tier_at(tile_hex_point tile_coords) const -> lod_tier;
+
+		//! Reschedules frozen beings that are no longer far from every section anchor.
+		auto thaw_beings() -> void;
+
+		//! Marks dirty every light source whose light could reach @p tile_coords, after an occluder there changed.
+		auto invalidate_lights_reaching(tile_hex_point tile_coords) -> void;
+
+		//! Recomputes the footprints of dirty light sources in the light map.
+		auto update_light_map() -> void;
+
+		//! Adds @p sign times each contribution in @p footprint to the light map, skipping unloaded tiles.
+		auto apply_light_footprint(light_footprint const& footprint, int sign) -> void;
+
+		//! Adds @p footprint to the light map as the footprint of the light source @p light_id.
+		auto add_light_footprint(ql::id light_id, light_footprint footprint) -> void;
+
+		//! Takes the footprint of the light source @p light_id back out of the light map, if it has one.
+		auto remove_light_footprint(ql::id light_id) -> void;
+
+		//! Performs some operation on each loaded section.
 		//! @param f The operation to perform on each section.
 		auto for_each_loaded_section(std::function<void(section&)> const& f) -> void;
 	};
 
-	auto make_region(reg& reg, id region_id, std::string name) -> id;
+	auto make_region(reg& reg, id region_id, std::string name, std::uint64_t world_seed) -> id;
 }
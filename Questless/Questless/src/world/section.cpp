@@ -3,34 +3,31 @@
 
 #include "section.hpp"
 
-#include "tile.hpp"
-
 #include "entities/beings/being.hpp"
 #include "magic/spell.hpp"
-#include "utility/random.hpp"
 #include "world/light_source.hpp"
 #include "world/region.hpp"
 
 namespace ql {
-	section::section(reg& reg, id region_id, section_hex_point coords) : _reg{&reg}, _coords{coords} {
-		// Create a section with random tiles.
-		auto const center = center_coords();
-		for (pace q = -section_radius; q <= section_radius; ++q) {
-			for (pace r = -section_radius; r <= section_radius; ++r) {
-				auto const terrain = static_cast<ql::terrain>(uniform(0, static_cast<int>(terrain::terrain_count) - 1));
-				auto const tile_coords = center + tile_hex_vector{q, r};
-				location location{region_id, tile_coords};
-				id const tile_id = reg.create();
-				make_tile(reg, tile_id, terrain, location, 0_temp, 0_lum);
-
-				// Add the tile's ID to the tile ID array.
-				auto [i, j] = indices(tile_coords);
-				_tile_ids[i][j] = tile_id;
+	section::section(reg& reg, section_blueprint const& blueprint)
+		: _reg{&reg}
+		, _terrain{blueprint.terrain}
+		, _temperature{blueprint.temperature}
+		, _luminance{blueprint.luminance}
+		, _coords{blueprint.coords} //
+	{
+		_ground_item_indices.fill(no_ground_items);
+
+		// Put back any items that were lying on the ground.
+		for (auto const& [tile_idx, item_ids] : blueprint.ground_items) {
+			auto& inv = ground_items(tile_idx);
+			for (auto item_id : item_ids) {
+				inv.add(item_id);
 			}
 		}
 	}
 
-	auto section::section_coords() const {
+	auto section::section_coords() const -> section_hex_point {
 		return _coords;
 	}
 
@@ -38,36 +35,85 @@ namespace ql {
 		return tile_hex_point{_coords.q.data * section_diameter, _coords.r.data * section_diameter};
 	}
 
-	auto section::entity_id_map() const -> std::unordered_map<tile_hex_point, id> const& {
-		return _entity_id_map;
+	auto section::contains(tile_hex_point tile_coords) const -> bool {
+		auto const offset = tile_coords - center_coords();
+		return -section_radius <= offset.q && offset.q <= section_radius && -section_radius <= offset.r &&
+			offset.r <= section_radius;
 	}
 
 	auto section::entity_id_at(tile_hex_point tile_coords) const -> std::optional<id> {
-		auto it = _entity_id_map.find(tile_coords);
-		return it != _entity_id_map.end() ? std::make_optional(it->second) : std::nullopt;
+		auto const tile_idx = tile_index(tile_coords);
+		return is_occupied(tile_idx) ? std::make_optional(_occupant_ids[tile_idx]) : std::nullopt;
 	}
 
 	auto section::try_add(id entity_id) -> bool {
-		auto result = _entity_id_map.insert({_reg->get<location>(entity_id).coords, entity_id});
-		return result.second;
+		auto const tile_idx = tile_index(_reg->get<location>(entity_id).coords);
+		if (is_occupied(tile_idx)) { return false; }
+		set_occupied(tile_idx, true);
+		_occupant_ids[tile_idx] = entity_id;
+		++_occupant_count;
+		return true;
+	}
+
+	auto section::try_move(id entity_id, tile_hex_point dst_coords) -> bool {
+		auto const src_idx = tile_index(_reg->get<location>(entity_id).coords);
+		auto const dst_idx = tile_index(dst_coords);
+		if (is_occupied(dst_idx)) { return false; }
+		set_occupied(src_idx, false);
+		set_occupied(dst_idx, true);
+		_occupant_ids[dst_idx] = entity_id;
+		return true;
 	}
 
 	auto section::remove_at(tile_hex_point coords) -> void {
-		auto it = _entity_id_map.find(coords);
-		if (it != _entity_id_map.end()) { _entity_id_map.erase(it); }
+		auto const tile_idx = tile_index(coords);
+		if (is_occupied(tile_idx)) {
+			set_occupied(tile_idx, false);
+			--_occupant_count;
+		}
 	}
 
 	auto section::remove(id entity_id) -> void {
 		remove_at(_reg->get<location>(entity_id).coords);
 	}
 
-	auto section::tile_id_at(tile_hex_point coords) const -> id {
-		auto [i, j] = indices(coords);
-		return _tile_ids[i][j];
+	auto section::tile_at(tile_hex_point coords) const -> tile_ref {
+		return tile_ref{this, tile_index(coords)};
 	}
 
-	auto section::indices(tile_hex_point coords) const -> std::tuple<size_t, size_t> {
+	auto section::tile_index(tile_hex_point coords) const -> std::size_t {
 		auto const offset = center_coords() - coords + tile_hex_vector{section_radius, section_radius};
-		return std::make_tuple(static_cast<size_t>(offset.q.data), static_cast<size_t>(offset.r.data));
+		return static_cast<std::size_t>(offset.q.data) * section_width + static_cast<std::size_t>(offset.r.data);
+	}
+
+	auto section::tile_coords(std::size_t tile_idx) const -> tile_hex_point {
+		auto const q = static_cast<int>(tile_idx / section_width);
+		auto const r = static_cast<int>(tile_idx % section_width);
+		return center_coords() + tile_hex_vector{section_radius, section_radius} - tile_hex_vector{pace{q}, pace{r}};
+	}
+
+	auto section::ground_items(std::size_t tile_idx) const -> inventory const* {
+		auto const ground_item_idx = _ground_item_indices[tile_idx];
+		return ground_item_idx == no_ground_items ? nullptr : &_ground_items[ground_item_idx];
+	}
+
+	auto section::ground_items(std::size_t tile_idx) -> inventory& {
+		auto& ground_item_idx = _ground_item_indices[tile_idx];
+		if (ground_item_idx == no_ground_items) {
+			ground_item_idx = static_cast<std::uint16_t>(_ground_items.size());
+			_ground_items.emplace_back();
+		}
+		return _ground_items[ground_item_idx];
+	}
+
+	auto section::save() const -> section_blueprint {
+		section_blueprint result{_coords, _terrain, _temperature, _luminance};
+		for (std::size_t tile_idx = 0; tile_idx < section_tile_count; ++tile_idx) {
+			if (auto const inv = ground_items(tile_idx); inv != nullptr && !inv->item_ids.empty()) {
+				result.ground_items.emplace_back(tile_idx, std::vector<id>{inv->item_ids.begin(), inv->item_ids.end()});
+			}
+		}
+		for_each_occupant([&](tile_hex_point, id entity_id) { result.occupant_ids.push_back(entity_id); });
+		return result;
 	}
 }
@@ -4,32 +4,86 @@
 #pragma once
 
 #include "coordinates.hpp"
+#include "section_blueprint.hpp"
+#include "tile.hpp"
 
+#include "items/inventory.hpp"
 #include "reg.hpp"
 #include "utility/reference.hpp"
 
+#include <algorithm>
 #include <array>
+#include <bit>
+#include <cstdint>
 #include <optional>
-#include <unordered_map>
+#include <span>
+#include <vector>
 
 namespace ql {
 	struct light_source;
 
 	//! An rhomboid section of hexes in a region.
 	struct section {
-		//! Generates a new section.
-		//! @param region_id The ID of the region containing this section.
-		//! @param coords The coordinates of the section within its region.
-		section(reg& reg, id region_id, section_hex_point coords);
+		//! Builds a section from @p blueprint.
+		//! @note Occupants and spawns listed in the blueprint are the region's responsibility.
+		section(reg& reg, section_blueprint const& blueprint);
+
+		//! The coordinates of the section containing the tile at @p tile_coords.
+		static constexpr auto containing_section_coords(tile_hex_point tile_coords) -> section_hex_point {
+			auto const q = tile_coords.q >= 0_pace //
+				? 1_section_span * (tile_coords.q + section_radius) / section_diameter
+				: 1_section_span * (tile_coords.q - section_radius) / section_diameter;
+			auto const r = tile_coords.r >= 0_pace //
+				? 1_section_span * (tile_coords.r + section_radius) / section_diameter
+				: 1_section_span * (tile_coords.r - section_radius) / section_diameter;
+			return section_hex_point{q, r};
+		}
 
 		//! The hex coordinates of this section within its region's sections.
-		auto section_coords() const;
+		auto section_coords() const -> section_hex_point;
 
 		//! The coordinates of this section's center tile.
 		auto center_coords() const -> tile_hex_point;
 
-		//! A map in this section of tile coordinates to occupying entities.
-		auto entity_id_map() const -> std::unordered_map<tile_hex_point, id> const&;
+		//! Whether the tile at @p tile_coords lies within this section.
+		auto contains(tile_hex_point tile_coords) const -> bool;
+
+		//! The number of entities in this section.
+		auto occupant_count() const -> std::size_t {
+			return _occupant_count;
+		}
+
+		//! Calls @p f with the coordinates and ID of each entity in this section, in tile index order.
+		template <typename F>
+		auto for_each_occupant(F&& f) const -> void {
+			if (_occupant_count == 0) { return; }
+			for_each_occupied_index(0, section_tile_count, [&](std::size_t tile_idx) {
+				f(tile_coords(tile_idx), _occupant_ids[tile_idx]);
+			});
+		}
+
+		//! Calls @p f with the coordinates and ID of each entity in this section within @p radius of @p origin.
+		//! @note Only scans the part of each row of tiles that intersects the query hexagon.
+		template <typename F>
+		auto for_each_occupant_within(tile_hex_point origin, pace radius, F&& f) const -> void {
+			if (_occupant_count == 0) { return; }
+			auto const center = center_coords();
+			auto const q_min = std::max(origin.q - radius, center.q - section_radius);
+			auto const q_max = std::min(origin.q + radius, center.q + section_radius);
+			for (pace q = q_min; q <= q_max; ++q) {
+				// Within the hexagon, r is bounded by both |r - origin.r| and |(q + r) - (origin.q + origin.r)|.
+				auto const dq = q - origin.q;
+				auto const r_min = std::max({origin.r - radius, origin.r - dq - radius, center.r - section_radius});
+				auto const r_max = std::min({origin.r + radius, origin.r - dq + radius, center.r + section_radius});
+				if (r_min > r_max) { continue; }
+				// Tile indices decrease as r increases, so the row's indices run from r_max to r_min.
+				auto const begin = tile_index({q, r_max});
+				auto const end = tile_index({q, r_min}) + 1;
+				for_each_occupied_index(begin, end, [&](std::size_t tile_idx) {
+					f(tile_coords(tile_idx), _occupant_ids[tile_idx]);
+				});
+			}
+		}
 
 		//! The ID of the entity at @p tile_coords or nullopt if there is none.
 		auto entity_id_at(tile_hex_point tile_coords) const -> std::optional<id>;
@@ -38,29 +92,140 @@ namespace ql {
 		//! at the entity's coordinates.
 		[[nodiscard]] auto try_add(id being_id) -> bool;
 
+		//! Tries to move the entity with ID @p entity_id from its current coordinates to @p dst_coords, both within
+		//! this section. Returns true on success or false if there is already an entity at @p dst_coords.
+		//! @note Does not update the entity's location.
+		[[nodiscard]] auto try_move(id entity_id, tile_hex_point dst_coords) -> bool;
+
 		//! Removes the being at the given region tile coordinates, if present.
 		auto remove_at(tile_hex_point coords) -> void;
 
 		//! Removes the entity with ID @p entity_id from this section, if present.
 		auto remove(id entity_id) -> void;
 
-		//! The ID of the tile at @p coords in this section.
+		//! A handle to the tile at @p coords in this section.
+		//! @note Behavior is undefined if @p coords is not within this section.
+		auto tile_at(tile_hex_point coords) const -> tile_ref;
+
+		//! The index of the tile at @p coords into this section's tile field arrays.
 		//! @note Behavior is undefined if @p coords is not within this section.
-		auto tile_id_at(tile_hex_point coords) const -> id;
+		auto tile_index(tile_hex_point coords) const -> std::size_t;
+
+		//! The coordinates of the tile at index @p tile_idx.
+		auto tile_coords(std::size_t tile_idx) const -> tile_hex_point;
+
+		//! The terrain of each tile in this section.
+		auto terrain() -> std::span<ql::terrain, section_tile_count> {
+			return _terrain;
+		}
+		auto terrain() const -> std::span<ql::terrain const, section_tile_count> {
+			return _terrain;
+		}
+
+		//! The temperature of each tile in this section.
+		auto temperature() -> std::span<ql::temperature, section_tile_count> {
+			return _temperature;
+		}
+		auto temperature() const -> std::span<ql::temperature const, section_tile_count> {
+			return _temperature;
+		}
+
+		//! The luminance of each tile in this section.
+		auto luminance() -> std::span<lum, section_tile_count> {
+			return _luminance;
+		}
+		auto luminance() const -> std::span<lum const, section_tile_count> {
+			return _luminance;
+		}
+
+		//! The light reaching each tile in this section from light sources, as maintained by the region's light map.
+		auto light() -> std::span<lum, section_tile_count> {
+			return _light;
+		}
+		auto light() const -> std::span<lum const, section_tile_count> {
+			return _light;
+		}
+
+		//! The items lying on the tile at index @p tile_idx, or null if there have never been any.
+		auto ground_items(std::size_t tile_idx) const -> inventory const*;
+
+		//! The items lying on the tile at index @p tile_idx, creating an empty inventory if necessary.
+		auto ground_items(std::size_t tile_idx) -> inventory&;
+
+		//! Calls @p f with the coordinates of each tile in this section with items on the ground and the ID of each
+		//! item on it, in tile index order.
+		template <typename F>
+		auto for_each_ground_item(F&& f) const -> void {
+			for (std::size_t tile_idx = 0; tile_idx < section_tile_count; ++tile_idx) {
+				auto const ground_item_idx = _ground_item_indices[tile_idx];
+				if (ground_item_idx == no_ground_items) { continue; }
+				for (auto const item_id : _ground_items[ground_item_idx].item_ids) {
+					f(tile_coords(tile_idx), item_id);
+				}
+			}
+		}
+
+		//! A blueprint capturing the current tiles and occupants of this section, suitable for rebuilding it later.
+		auto save() const -> section_blueprint;
 
 	private:
+		//! Marks a tile with no ground inventory.
+		static constexpr std::uint16_t no_ground_items = UINT16_MAX;
+		static_assert(section_tile_count < no_ground_items);
+
 		reg_ptr _reg;
 
-		//! A q-major array of tiles, representing a rhomboid section of tiles centered on this section's hex coordinates.
-		std::array<std::array<id, section_diameter.data>, section_diameter.data> _tile_ids;
+		// Tiles are stored as parallel field arrays in q-major order, representing a rhomboid section of tiles centered
+		// on this section's hex coordinates.
+
+		std::array<ql::terrain, section_tile_count> _terrain;
+		std::array<ql::temperature, section_tile_count> _temperature;
+		std::array<lum, section_tile_count> _luminance;
+		//! Not saved, since light sources are propagated into it again whenever the section is loaded.
+		std::array<lum, section_tile_count> _light{};
+		//! Each tile's index into @p _ground_items, or @p no_ground_items. Most tiles never hold items, so inventories
+		//! are only allocated on demand.
+		std::array<std::uint16_t, section_tile_count> _ground_item_indices;
+		std::vector<inventory> _ground_items;
 
-		std::unordered_map<tile_hex_point, id> _entity_id_map;
+		static constexpr std::size_t occupancy_word_bits = 64;
+
+		//! Which tiles have an occupant, one bit per tile index.
+		std::array<std::uint64_t, (section_tile_count + occupancy_word_bits - 1) / occupancy_word_bits> _occupancy{};
+
+		//! The occupant of each tile, indexed like the tile field arrays. Only meaningful where the occupancy bit is
+		//! set.
+		std::array<id, section_tile_count> _occupant_ids;
+
+		std::size_t _occupant_count = 0;
 
 		//! The hex coordinates of this section within its region.
 		section_hex_point _coords;
 
-		//! The array indices of the tile at @p coords.
-		//! @note Behavior is undefined if @p coords is not within this section.
-		auto indices(tile_hex_point coords) const -> std::tuple<size_t, size_t>;
+		//! Calls @p f with the index of each occupied tile with index in [@p begin, @p end).
+		template <typename F>
+		auto for_each_occupied_index(std::size_t begin, std::size_t end, F&& f) const -> void {
+			for (std::size_t word_idx = begin / occupancy_word_bits; word_idx * occupancy_word_bits < end; ++word_idx) {
+				auto const word_begin = word_idx * occupancy_word_bits;
+				auto word = _occupancy[word_idx];
+				// Mask off bits outside the range.
+				if (begin > word_begin) { word &= ~std::uint64_t{0} << (begin - word_begin); }
+				if (end < word_begin + occupancy_word_bits) { word &= (std::uint64_t{1} << (end - word_begin)) - 1; }
+				// Visit each set bit, clearing the lowest one each time.
+				for (; word != 0; word &= word - 1) {
+					f(word_begin + static_cast<std::size_t>(std::countr_zero(word)));
+				}
+			}
+		}
+
+		auto is_occupied(std::size_t tile_idx) const -> bool {
+			return (_occupancy[tile_idx / occupancy_word_bits] >> (tile_idx % occupancy_word_bits)) & 1;
+		}
+
+		auto set_occupied(std::size_t tile_idx, bool occupied) -> void {
+			auto const mask = std::uint64_t{1} << (tile_idx % occupancy_word_bits);
+			auto& word = _occupancy[tile_idx / occupancy_word_bits];
+			word = occupied ? word | mask : word & ~mask;
+		}
 	};
 }
@@ -0,0 +1,52 @@
+//! @file
+//! @copyright See <a href="LICENSE.txt">LICENSE.txt</a>.
+
+#include "section_blueprint.hpp"
+
+#include "utility/random.hpp"
+
+#include <algorithm>
+#include <execution>
+
+namespace ql {
+	auto generate_section_blueprint(std::uint64_t region_key, section_hex_point coords) -> section_blueprint {
+		section_blueprint result{coords};
+
+		// Each section draws from its own stream, keyed by the region and the section's coordinates.
+		keyed_prng prng{combine_keys(combine_keys(region_key, static_cast<std::uint64_t>(coords.q.data)),
+			static_cast<std::uint64_t>(coords.r.data))};
+
+		// Random terrain. Temperature and luminance start at zero.
+		for (auto& terrain : result.terrain) {
+			terrain = static_cast<ql::terrain>(prng.uniform(0, static_cast<int>(terrain::terrain_count) - 1));
+		}
+
+		// Add entities randomly, except in the central section, which is kept clear for the player.
+		if (coords != section_hex_point{0_section_span, 0_section_span}) {
+			tile_hex_point const center{coords.q.data * section_diameter, coords.r.data * section_diameter};
+			for (pace q = -section_radius; q <= section_radius; ++q) {
+				for (pace r = -section_radius; r <= section_radius; ++r) {
+					if (prng.uniform(0, 10) == 0) {
+						auto const kind = prng.uniform(0, 12) == 0 //
+							? section_blueprint::spawn::entity_kind::campfire
+							: section_blueprint::spawn::entity_kind::human;
+						result.spawns.push_back({center + tile_hex_vector{q, r}, kind});
+					}
+				}
+			}
+		}
+
+		return result;
+	}
+
+	auto generate_section_blueprints(std::uint64_t region_key, std::vector<section_hex_point> const& coords)
+		-> std::vector<section_blueprint> //
+	{
+		std::vector<section_blueprint> result(coords.size());
+		std::transform(
+			std::execution::par, coords.begin(), coords.end(), result.begin(), [region_key](auto section_coords) {
+				return generate_section_blueprint(region_key, section_coords);
+			});
+		return result;
+	}
+}
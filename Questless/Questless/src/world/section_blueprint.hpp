@@ -0,0 +1,70 @@
+//! @file
+//! @copyright See <a href="LICENSE.txt">LICENSE.txt</a>.
+
+#pragma once
+
+#include "coordinates.hpp"
+#include "terrain.hpp"
+
+#include "quantities/misc.hpp"
+#include "reg.hpp"
+
+#include "cancel/serialization.hpp"
+
+#include <cereal/types/array.hpp>
+#include <cereal/types/utility.hpp>
+#include <cereal/types/vector.hpp>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace ql {
+	//! The number of tiles along each axis of a section.
+	constexpr auto section_width = static_cast<std::size_t>(section_diameter.data);
+
+	//! The number of tiles in a section.
+	constexpr auto section_tile_count = section_width * section_width;
+
+	//! Registry-independent contents of a section, from which the section can be built on the game thread. Blueprints
+	//! are produced by world generation or by evicting a loaded section, and are cheap to build off the game thread.
+	struct section_blueprint {
+		//! Something to create in a newly generated section.
+		struct spawn {
+			enum class entity_kind : int { campfire, human };
+
+			tile_hex_point coords;
+			entity_kind kind;
+		};
+
+		//! The hex coordinates of the section within its region.
+		section_hex_point coords;
+
+		//! Per-tile data, in the same q-major order as a section's tile array.
+		std::array<ql::terrain, section_tile_count> terrain{};
+		std::array<ql::temperature, section_tile_count> temperature{};
+		std::array<lum, section_tile_count> luminance{};
+
+		//! The IDs of items lying on tiles, keyed by tile index.
+		std::vector<std::pair<std::size_t, std::vector<id>>> ground_items{};
+
+		//! The IDs of entities that occupied the section when it was evicted.
+		std::vector<id> occupant_ids{};
+
+		//! Entities to create when the section is first built. Empty for previously evicted sections.
+		std::vector<spawn> spawns{};
+
+		template <typename Archive>
+		auto serialize(Archive& archive) -> void {
+			archive(coords.q, coords.r, terrain, temperature, luminance, ground_items, occupant_ids);
+		}
+	};
+
+	//! Pseudo-randomly generates the blueprint of a new section at @p coords in the region with key @p region_key.
+	//! @note The result depends only on the arguments, so sections can be generated in any order and on any thread.
+	auto generate_section_blueprint(std::uint64_t region_key, section_hex_point coords) -> section_blueprint;
+
+	//! Generates the blueprints of the sections at each of @p coords in parallel, in the same order as @p coords.
+	auto generate_section_blueprints(std::uint64_t region_key, std::vector<section_hex_point> const& coords)
+		-> std::vector<section_blueprint>;
+}
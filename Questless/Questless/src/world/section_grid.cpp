@@ -0,0 +1,93 @@
+//! @file
+//! @copyright See <a href="LICENSE.txt">LICENSE.txt</a>.
+
+#include "section_grid.hpp"
+
+#include <optional>
+
+namespace ql {
+	namespace {
+		constexpr std::size_t initial_capacity = 64;
+	}
+
+	section_grid::section_grid() : _slots(initial_capacity) {}
+
+	auto section_grid::find(section_hex_point coords) -> section* {
+		return _slots[probe(coords)].section_ptr.get();
+	}
+
+	auto section_grid::find(section_hex_point coords) const -> section const* {
+		return _slots[probe(coords)].section_ptr.get();
+	}
+
+	auto section_grid::insert(uptr<section> new_section) -> section& {
+		// Keep the load factor, including tombstones, at or below one half. Grow if live sections alone would fill more
+		// than a quarter of the slots; otherwise rehashing in place is enough to clear out tombstones.
+		if (2 * (_occupied + 1) > _slots.size()) {
+			rehash(4 * (_size + 1) > _slots.size() ? 2 * _slots.size() : _slots.size());
+		}
+
+		auto const coords = new_section->section_coords();
+		auto& slot = _slots[probe_for_insert(coords)];
+		if (!slot.section_ptr) {
+			++_size;
+			if (!slot.tombstone) { ++_occupied; }
+		}
+		slot.coords = coords;
+		slot.section_ptr = std::move(new_section);
+		slot.tombstone = false;
+		return *slot.section_ptr;
+	}
+
+	auto section_grid::extract(section_hex_point coords) -> uptr<section> {
+		auto& slot = _slots[probe(coords)];
+		if (!slot.section_ptr) { return nullptr; }
+		--_size;
+		slot.tombstone = true;
+		return std::move(slot.section_ptr);
+	}
+
+	auto section_grid::probe(section_hex_point coords) const -> std::size_t {
+		std::size_t const mask = _slots.size() - 1;
+		std::size_t idx = static_cast<std::size_t>(hash(coords)) & mask;
+		// Linear probing. Terminates because the load factor is kept below one.
+		for (;;) {
+			auto const& slot = _slots[idx];
+			if (slot.section_ptr ? slot.coords == coords : !slot.tombstone) { return idx; }
+			idx = (idx + 1) & mask;
+		}
+	}
+
+	auto section_grid::probe_for_insert(section_hex_point coords) const -> std::size_t {
+		std::size_t const mask = _slots.size() - 1;
+		std::size_t idx = static_cast<std::size_t>(hash(coords)) & mask;
+		std::optional<std::size_t> o_first_tombstone_idx;
+		for (;;) {
+			auto const& slot = _slots[idx];
+			if (slot.section_ptr) {
+				if (slot.coords == coords) { return idx; }
+			} else if (slot.tombstone) {
+				if (!o_first_tombstone_idx) { o_first_tombstone_idx = idx; }
+			} else {
+				return o_first_tombstone_idx.value_or(idx);
+			}
+			idx = (idx + 1) & mask;
+		}
+	}
+
+	auto section_grid::rehash(std::size_t capacity) -> void {
+		std::vector<slot> old_slots(capacity);
+		std::swap(old_slots, _slots);
+		_size = 0;
+		_occupied = 0;
+		for (auto& slot : old_slots) {
+			if (slot.section_ptr) {
+				auto& new_slot = _slots[probe(slot.coords)];
+				new_slot.coords = slot.coords;
+				new_slot.section_ptr = std::move(slot.section_ptr);
+				++_size;
+				++_occupied;
+			}
+		}
+	}
+}
@@ -0,0 +1,191 @@
+//! @file
+//! @copyright See <a href="LICENSE.txt">LICENSE.txt</a>.
+
+#pragma once
+
+#include "section.hpp"
+
+#include "utility/reference.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace ql {
+	//! A flat, open-addressed directory of sections, keyed by section coordinates.
+	//! @note Sections are heap-allocated so that pointers to them remain valid while the directory grows.
+	struct section_grid {
+		section_grid();
+
+		//! Mixes section coordinates into a well-distributed hash. The simple hash_value of hex points clusters badly
+		//! under a power-of-two mask.
+		static constexpr auto hash(section_hex_point coords) -> std::uint64_t {
+			std::uint64_t x = (static_cast<std::uint64_t>(static_cast<std::uint32_t>(coords.q.data)) << 32) |
+				static_cast<std::uint32_t>(coords.r.data);
+			x ^= x >> 33;
+			x *= 0xff51afd7ed558ccdull;
+			x ^= x >> 33;
+			x *= 0xc4ceb9fe1a85ec53ull;
+			x ^= x >> 33;
+			return x;
+		}
+
+		//! The section at @p coords or nullptr if none.
+		auto find(section_hex_point coords) -> section*;
+
+		//! The section at @p coords or nullptr if none.
+		auto find(section_hex_point coords) const -> section const*;
+
+		//! Adds @p new_section to the grid, replacing any section already at its coordinates.
+		//! @return A reference to the added section.
+		auto insert(uptr<section> new_section) -> section&;
+
+		//! Removes and returns the section at @p coords or nullptr if none.
+		auto extract(section_hex_point coords) -> uptr<section>;
+
+		//! The number of sections in the grid.
+		auto size() const -> std::size_t {
+			return _size;
+		}
+
+		//! The number of slots in the grid, always a power of two.
+		auto capacity() const -> std::size_t {
+			return _slots.size();
+		}
+
+		//! The number of slots vacated by @p extract that haven't since been reused or cleared by a rehash.
+		auto tombstone_count() const -> std::size_t {
+			return _occupied - _size;
+		}
+
+		//! Performs @p f on each section in the grid, in unspecified order.
+		template <typename F>
+		auto for_each(F&& f) -> void {
+			for (auto& slot : _slots) {
+				if (slot.section_ptr) { f(*slot.section_ptr); }
+			}
+		}
+
+		//! Performs @p f on each section in the grid, in unspecified order.
+		template <typename F>
+		auto for_each(F&& f) const -> void {
+			for (auto const& slot : _slots) {
+				if (slot.section_ptr) { f(static_cast<section const&>(*slot.section_ptr)); }
+			}
+		}
+
+	private:
+		struct slot {
+			section_hex_point coords{};
+			uptr<section> section_ptr{};
+			//! Whether this slot used to hold a section. Tombstones keep probe sequences intact after removal.
+			bool tombstone = false;
+		};
+
+		//! Capacity is always a power of two so that the hash can be reduced with a mask.
+		std::vector<slot> _slots;
+
+		//! The number of live sections.
+		std::size_t _size = 0;
+
+		//! The number of live sections plus the number of tombstones.
+		std::size_t _occupied = 0;
+
+		//! The index of the slot holding @p coords or of the empty slot where the probe sequence for @p coords ends.
+		auto probe(section_hex_point coords) const -> std::size_t;
+
+		//! The index of the slot holding @p coords or, if none, of the slot where @p coords should be inserted: the
+		//! first tombstone in its probe sequence or else the empty slot where the sequence ends.
+		auto probe_for_insert(section_hex_point coords) const -> std::size_t;
+
+		//! Rebuilds the slot array with @p capacity slots, dropping tombstones.
+		auto rehash(std::size_t capacity) -> void;
+	};
+}
+
+#include "doctest_wrapper/test.hpp"
+
+TEST_CASE("[section_grid] operations") {
+	using namespace ql;
+
+	reg reg;
+	auto const make_section = [&](section_hex_point coords) {
+		section_blueprint blueprint{};
+		blueprint.coords = coords;
+		return umake<section>(reg, blueprint);
+	};
+	auto const contains = [](section_grid const& grid, section_hex_point coords) {
+		auto const found = grid.find(coords);
+		return found != nullptr && found->section_coords() == coords;
+	};
+
+	section_grid grid;
+
+	SUBCASE("probe wraparound and tombstone reuse") {
+		// Find coordinates that all hash to the last slot, so that probing for all but the first wraps around.
+		std::size_t const last_slot = grid.capacity() - 1;
+		std::vector<section_hex_point> colliding;
+		for (int q = -20; q <= 20 && colliding.size() < 4; ++q) {
+			for (int r = -20; r <= 20 && colliding.size() < 4; ++r) {
+				section_hex_point const coords{section_span{q}, section_span{r}};
+				if ((section_grid::hash(coords) & last_slot) == last_slot) { colliding.push_back(coords); }
+			}
+		}
+		REQUIRE_EQ(colliding.size(), 4u);
+
+		for (std::size_t i = 0; i < 3; ++i) {
+			grid.insert(make_section(colliding[i]));
+		}
+		REQUIRE_EQ(grid.capacity(), last_slot + 1);
+		CHECK(contains(grid, colliding[0]));
+		CHECK(contains(grid, colliding[1]));
+		CHECK(contains(grid, colliding[2]));
+		CHECK_EQ(grid.find(colliding[3]), nullptr);
+
+		// Extracting from the middle of the probe sequence leaves a tombstone that keeps the rest reachable.
+		auto const extracted = grid.extract(colliding[1]);
+		REQUIRE_NE(extracted, nullptr);
+		CHECK_EQ(extracted->section_coords(), colliding[1]);
+		CHECK_EQ(grid.size(), 2u);
+		CHECK_EQ(grid.tombstone_count(), 1u);
+		CHECK_EQ(grid.find(colliding[1]), nullptr);
+		CHECK(contains(grid, colliding[2]));
+
+		// The next colliding insertion takes the tombstone's slot.
+		grid.insert(make_section(colliding[3]));
+		CHECK_EQ(grid.size(), 3u);
+		CHECK_EQ(grid.tombstone_count(), 0u);
+		CHECK(contains(grid, colliding[0]));
+		CHECK(contains(grid, colliding[2]));
+		CHECK(contains(grid, colliding[3]));
+	}
+	SUBCASE("rehash on growth with negative coordinates") {
+		constexpr int extent = 10;
+		std::vector<section*> inserted;
+		for (int q = -extent; q <= extent; ++q) {
+			for (int r = -extent; r <= extent; ++r) {
+				inserted.push_back(&grid.insert(make_section({section_span{q}, section_span{r}})));
+			}
+		}
+		CHECK_EQ(grid.size(), inserted.size());
+		// The load factor stays at or below one half.
+		CHECK_GE(grid.capacity(), 2 * grid.size());
+
+		// Sections are found at the same addresses they had when inserted, before any rehashing.
+		std::size_t idx = 0;
+		for (int q = -extent; q <= extent; ++q) {
+			for (int r = -extent; r <= extent; ++r) {
+				section_hex_point const coords{section_span{q}, section_span{r}};
+				CHECK_EQ(grid.find(coords), inserted[idx++]);
+			}
+		}
+		CHECK_EQ(grid.find({section_span{extent + 1}, 0_section_span}), nullptr);
+		CHECK_EQ(grid.find({0_section_span, section_span{-extent - 1}}), nullptr);
+
+		// Negative coordinates hash differently from their mirror images.
+		section_hex_point const minus_q{section_span{-1}, 0_section_span};
+		section_hex_point const plus_q{1_section_span, 0_section_span};
+		section_hex_point const minus_r{0_section_span, section_span{-1}};
+		CHECK_NE(section_grid::hash(minus_q), section_grid::hash(plus_q));
+		CHECK_NE(section_grid::hash(minus_q), section_grid::hash(minus_r));
+	}
+}
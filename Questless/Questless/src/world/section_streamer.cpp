@@ -0,0 +1,148 @@
+//! @file
+//! @copyright See <a href="LICENSE.txt">LICENSE.txt</a>.
+
+#include "section_streamer.hpp"
+
+#include "utility/visitation.hpp"
+
+#include <cereal/archives/binary.hpp>
+#include <fmt/format.h>
+
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <system_error>
+
+namespace ql {
+	namespace {
+		//! Creates a new, empty directory under the system's temporary directory, with a name starting with @p prefix.
+		auto create_unique_directory(std::string_view prefix) -> std::filesystem::path {
+			// Draw the suffix from the system rather than the game's generators, so that streaming doesn't perturb
+			// simulation randomness.
+			std::random_device rng{};
+			auto const parent = std::filesystem::temp_directory_path() / "questless";
+			std::filesystem::create_directories(parent);
+			for (;;) {
+				auto const suffix = (static_cast<std::uint64_t>(rng()) << 32) | rng();
+				auto result = parent / fmt::format("{}-{:016x}", prefix, suffix);
+				// Only succeeds if the directory didn't already exist.
+				if (std::filesystem::create_directory(result)) { return result; }
+			}
+		}
+	}
+
+	section_streamer::section_streamer(std::string_view cache_name, std::uint64_t region_key)
+		// Entity IDs in cached sections are only meaningful to the registry that produced them, so each streamer
+		// starts from a fresh directory of its own.
+		: _cache_dir{create_unique_directory(cache_name)}
+		, _region_key{region_key} //
+	{
+		_worker = std::thread{[this] { run(); }};
+	}
+
+	section_streamer::~section_streamer() {
+		{
+			std::scoped_lock lock{_mutex};
+			_stopping = true;
+		}
+		_cv.notify_one();
+		_worker.join();
+
+		std::error_code ec;
+		std::filesystem::remove_all(_cache_dir, ec);
+	}
+
+	auto section_streamer::request_load(section_hex_point coords) -> void {
+		{
+			std::scoped_lock lock{_mutex};
+			_jobs.push_back(load_job{coords});
+		}
+		_cv.notify_one();
+	}
+
+	auto section_streamer::request_store(section_blueprint blueprint) -> void {
+		{
+			std::scoped_lock lock{_mutex};
+			_jobs.push_back(store_job{std::move(blueprint)});
+		}
+		_cv.notify_one();
+	}
+
+	auto section_streamer::poll() -> std::vector<section_blueprint> {
+		std::vector<section_blueprint> result;
+		// Don't wait for the lock if the worker currently holds it. Anything left over is picked up next poll.
+		std::unique_lock lock{_mutex, std::try_to_lock};
+		if (lock.owns_lock()) { std::swap(result, _completed); }
+		return result;
+	}
+
+	auto section_streamer::wait() -> std::vector<section_blueprint> {
+		std::vector<section_blueprint> result;
+		std::unique_lock lock{_mutex};
+		_completed_cv.wait(lock, [this] { return !_completed.empty(); });
+		std::swap(result, _completed);
+		return result;
+	}
+
+	auto section_streamer::cache_path(section_hex_point coords) const -> std::filesystem::path {
+		return _cache_dir / (std::to_string(coords.q.data) + '_' + std::to_string(coords.r.data) + ".section");
+	}
+
+	auto section_streamer::load(std::vector<section_hex_point> const& coords) -> std::vector<section_blueprint> {
+		std::vector<section_blueprint> result;
+		std::vector<section_hex_point> generated_coords;
+		for (auto const section_coords : coords) {
+			if (_cached.contains(section_coords)) {
+				std::ifstream fin{cache_path(section_coords), std::ios::binary};
+				cereal::BinaryInputArchive archive{fin};
+				archive(result.emplace_back());
+			} else {
+				generated_coords.push_back(section_coords);
+			}
+		}
+		auto generated = generate_section_blueprints(_region_key, generated_coords);
+		std::move(generated.begin(), generated.end(), std::back_inserter(result));
+		return result;
+	}
+
+	auto section_streamer::run() -> void {
+		for (;;) {
+			std::variant<load_job, store_job> job;
+			// Consecutive loads are batched so that their sections can be generated in parallel.
+			std::vector<section_hex_point> load_coords;
+			{
+				std::unique_lock lock{_mutex};
+				_cv.wait(lock, [this] { return _stopping || !_jobs.empty(); });
+				if (_stopping) { return; }
+				job = std::move(_jobs.front());
+				_jobs.pop_front();
+				if (auto load = std::get_if<load_job>(&job)) {
+					load_coords.push_back(load->coords);
+					while (!_jobs.empty() && std::holds_alternative<load_job>(_jobs.front())) {
+						load_coords.push_back(std::get<load_job>(_jobs.front()).coords);
+						_jobs.pop_front();
+					}
+				}
+			}
+
+			// Jobs are processed in order, so a load always sees any earlier store of the same section.
+			match(
+				job,
+				[this, &load_coords](load_job const&) {
+					auto blueprints = load(load_coords);
+					{
+						std::scoped_lock lock{_mutex};
+						std::move(blueprints.begin(), blueprints.end(), std::back_inserter(_completed));
+					}
+					_completed_cv.notify_one();
+				},
+				[this](store_job const& store) {
+					std::ofstream fout{cache_path(store.blueprint.coords), std::ios::binary};
+					cereal::BinaryOutputArchive archive{fout};
+					archive(store.blueprint);
+					_cached.insert(store.blueprint.coords);
+				});
+		}
+	}
+}
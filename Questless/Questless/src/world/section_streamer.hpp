@@ -0,0 +1,82 @@
+//! @file
+//! @copyright See <a href="LICENSE.txt">LICENSE.txt</a>.
+
+#pragma once
+
+#include "section_blueprint.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <cstdint>
+#include <set>
+#include <string_view>
+#include <thread>
+#include <variant>
+#include <vector>
+
+namespace ql {
+	//! Generates, loads, and stores section blueprints on a background worker thread so the game thread rarely waits on
+	//! world generation or disk I/O.
+	struct section_streamer {
+		//! @param cache_name Identifies the cache in the name of its directory, which is created under the system's
+		//! temporary directory with a suffix unique to this streamer.
+		//! @param region_key The key of the region whose sections are generated.
+		section_streamer(std::string_view cache_name, std::uint64_t region_key);
+
+		//! Stops the worker and removes the cache directory.
+		~section_streamer();
+
+		section_streamer(section_streamer const&) = delete;
+		auto operator=(section_streamer const&) -> section_streamer& = delete;
+
+		//! Requests the blueprint for the section at @p coords, loading it from the cache if it was previously stored
+		//! or generating it otherwise. The result is delivered through @p poll or @p wait.
+		auto request_load(section_hex_point coords) -> void;
+
+		//! Requests that @p blueprint be written to the cache.
+		auto request_store(section_blueprint blueprint) -> void;
+
+		//! Removes and returns all blueprints completed since the last poll. Never blocks on the worker.
+		auto poll() -> std::vector<section_blueprint>;
+
+		//! Waits until at least one blueprint has been completed since the last poll or wait, and then removes and
+		//! returns all of them. Only call while a load is outstanding.
+		auto wait() -> std::vector<section_blueprint>;
+
+	private:
+		struct load_job {
+			section_hex_point coords;
+		};
+		struct store_job {
+			section_blueprint blueprint;
+		};
+
+		//! The directory in which evicted sections are stored. Owned by this streamer, so that other streamers, even in
+		//! other processes, can't discard or overwrite its contents.
+		std::filesystem::path _cache_dir;
+
+		std::uint64_t _region_key;
+
+		//! Coordinates of sections in the cache. Only used on the worker thread.
+		std::set<section_hex_point> _cached;
+
+		std::mutex _mutex;
+		std::condition_variable _cv;
+		//! Notified when blueprints are completed.
+		std::condition_variable _completed_cv;
+		std::deque<std::variant<load_job, store_job>> _jobs;
+		std::vector<section_blueprint> _completed;
+		bool _stopping = false;
+
+		std::thread _worker;
+
+		auto cache_path(section_hex_point coords) const -> std::filesystem::path;
+
+		//! Loads or generates the blueprints of the sections at @p coords, generating in parallel.
+		auto load(std::vector<section_hex_point> const& coords) -> std::vector<section_blueprint>;
+
+		auto run() -> void;
+	};
+}
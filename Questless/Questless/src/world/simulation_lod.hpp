@@ -0,0 +1,42 @@
+//! @file
+//! @copyright See <a href="LICENSE.txt">LICENSE.txt</a>.
+
+#pragma once
+
+#include "coordinates.hpp"
+
+#include "quantities/game_time.hpp"
+
+namespace ql {
+	//! How closely a being is simulated.
+	enum class lod_tier {
+		//! Takes every turn it's due.
+		near,
+		//! Takes turns no more often than a fixed period.
+		mid,
+		//! Takes no turns until it's nearer to an observer. Its body catches up on the missed time all at once.
+		far
+	};
+
+	//! Sets how closely beings are simulated by their distance from the nearest observer, i.e. section anchor, so that
+	//! time isn't spent on detail no one is around to see.
+	struct simulation_lod {
+		//! Beings within this distance of an observer are fully simulated. This should exceed observers' visual ranges
+		//! by at least as far as they can move in @p mid_period, so that beings they can see are always near.
+		pace near_radius = section_diameter;
+
+		//! Beings within this distance of an observer but not near are mid-range.
+		pace mid_radius = 2 * section_diameter;
+
+		//! The minimum time between the starts of a mid-range being's turns. Far beings are also checked for return to
+		//! range this often.
+		tick mid_period = 8_tick;
+
+		//! The tier of a being @p distance from the nearest observer.
+		constexpr auto tier_at(pace distance) const -> lod_tier {
+			if (distance <= near_radius) { return lod_tier::near; }
+			if (distance <= mid_radius) { return lod_tier::mid; }
+			return lod_tier::far;
+		}
+	};
+}
@@ -30,7 +30,10 @@ namespace ql {
 
 		// Create player being.
 		id const player_id = reg.create();
-		make_human(reg, player_id, location, {player{}});
+		make_human(reg, player_id, location, {player{reg, player_id}});
+
+		// Keep the world loaded around the player.
+		reg.assign<section_anchor>(player_id);
 
 		// Add to region.
 		bool const success = reg.get<region>(region_id).try_add(player_id, location.coords);
@@ -3,7 +3,9 @@
 
 #pragma once
 
+#include <cstdint>
+
 namespace ql {
 	//! Type of terrain on a tile.
-	enum class terrain : int { dirt = 0, edge, grass, sand, snow, stone, water, terrain_count };
+	enum class terrain : std::uint8_t { dirt = 0, edge, grass, sand, snow, stone, water, terrain_count };
 }
@@ -1,18 +1,32 @@
 //! @file
 //! @copyright See <a href="LICENSE.txt">LICENSE.txt</a>.
 
-#pragma once
-
 #include "tile.hpp"
 
+#include "section.hpp"
+
 namespace ql {
-	auto make_tile(reg& reg, id tile_id, terrain terrain, location location, temperature temperature, lum luminance) -> id {
-		reg.assign<ql::terrain>(tile_id, terrain);
-		reg.assign<ql::location>(tile_id, location);
-		reg.assign<ql::temperature>(tile_id, temperature);
-		reg.assign<lum>(tile_id, luminance);
-		reg.assign<inventory>(tile_id);
-
-		return tile_id;
+	auto tile_ref::coords() const -> tile_hex_point {
+		return section_ptr->tile_coords(idx);
+	}
+
+	auto tile_ref::terrain() const -> ql::terrain {
+		return section_ptr->terrain()[idx];
+	}
+
+	auto tile_ref::temperature() const -> ql::temperature {
+		return section_ptr->temperature()[idx];
+	}
+
+	auto tile_ref::luminance() const -> lum {
+		return section_ptr->luminance()[idx];
+	}
+
+	auto tile_ref::light() const -> lum {
+		return section_ptr->light()[idx];
+	}
+
+	auto tile_ref::ground_items() const -> inventory const* {
+		return section_ptr->ground_items(idx);
 	}
 }
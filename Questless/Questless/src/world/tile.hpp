@@ -6,14 +6,40 @@
 #include "coordinates.hpp"
 #include "terrain.hpp"
 
-#include "items/inventory.hpp"
 #include "quantities/misc.hpp"
 
+#include <cstddef>
+
 namespace ql {
-	//! Makes @p tile_id a tile, a hexagonal region of the world.
-	//! @param terrain The terrain on this tile.
-	//! @param location This tile's location in the world.
-	//! @param temperature The temperature at this tile.
-	//! @param luminance The amount of light at this tile.
-	auto make_tile(reg& reg, id tile_id, terrain terrain, location location, temperature temperature, lum luminance) -> id;
+	struct inventory;
+	struct section;
+
+	//! A lightweight, read-only handle to a tile, a hexagonal region of the world. Tile data lives in the field arrays
+	//! of the containing section.
+	//! @note Invalidated when the containing section is unloaded.
+	struct tile_ref {
+		//! The section containing the tile.
+		section const* section_ptr;
+
+		//! The index of the tile into its section's field arrays.
+		std::size_t idx;
+
+		//! This tile's location within its region.
+		auto coords() const -> tile_hex_point;
+
+		//! The terrain on this tile.
+		auto terrain() const -> ql::terrain;
+
+		//! The temperature at this tile.
+		auto temperature() const -> ql::temperature;
+
+		//! The amount of light given off by this tile itself.
+		auto luminance() const -> lum;
+
+		//! The amount of light reaching this tile from light sources.
+		auto light() const -> lum;
+
+		//! The items lying on this tile, or null if there have never been any.
+		auto ground_items() const -> inventory const*;
+	};
 }